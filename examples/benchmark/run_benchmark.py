@@ -0,0 +1,641 @@
+"""
+Micro and macro benchmarks of trading hot paths.
+
+Results are printed and saved into a JSON file, which can be compared
+between releases to find performance regressions.
+
+Usage:
+    python run_benchmark.py [--output result.json] [--filter name] [--scale 1.0] [--timeout 600]
+
+Benchmark not finished within timeout is recorded as failed, and the
+remaining benchmarks are still run.
+"""
+
+import argparse
+import json
+import platform
+import random
+import socket
+import sys
+from datetime import datetime, timedelta
+from threading import Event as TEvent, Thread
+from time import perf_counter_ns
+from types import SimpleNamespace
+from typing import Callable, Dict, List
+
+import numpy as np
+
+from vnpy import __version__
+from vnpy.event import Event, EventEngine
+from vnpy.rpc import RpcClient, RpcServer
+from vnpy.trader.constant import Direction, Exchange, Interval, Offset, Product, Status
+from vnpy.trader.converter import PositionHolding
+from vnpy.trader.engine import OmsEngine
+from vnpy.trader.event import EVENT_TICK
+from vnpy.trader.gateway import BaseGateway
+from vnpy.trader.object import (
+    BarData,
+    ContractData,
+    OrderData,
+    PositionData,
+    TickData,
+    TradeData
+)
+from vnpy.trader.utility import ArrayManager, BarGenerator
+
+
+SEED: int = 20240101
+BENCHMARKS: Dict[str, Callable] = {}
+
+
+def benchmark(name: str) -> Callable:
+    """
+    Register benchmark function with name.
+    """
+    def register(func: Callable) -> Callable:
+        BENCHMARKS[name] = func
+        return func
+
+    return register
+
+
+def measure(func: Callable, n: int, repeat: int = 5) -> dict:
+    """
+    Call func n times in each repeat after warm up, and return
+    statistics of time per call in nanoseconds.
+    """
+    for _ in range(min(n, 1000)):
+        func()
+
+    results: List[float] = []
+
+    for _ in range(repeat):
+        start: int = perf_counter_ns()
+        for _ in range(n):
+            func()
+        end: int = perf_counter_ns()
+
+        results.append((end - start) / n)
+
+    results.sort()
+    median: float = results[len(results) // 2]
+
+    return {
+        "calls": n * repeat,
+        "min_ns": round(results[0], 1),
+        "median_ns": round(median, 1),
+        "ops_per_sec": round(1e9 / median, 1),
+    }
+
+
+def get_percentiles(samples: List[int]) -> dict:
+    """
+    Get latency percentiles of samples in nanoseconds.
+    """
+    array: np.ndarray = np.array(samples)
+
+    return {
+        "samples": len(samples),
+        "p50_ns": float(np.percentile(array, 50)),
+        "p99_ns": float(np.percentile(array, 99)),
+        "p999_ns": float(np.percentile(array, 99.9)),
+        "max_ns": float(array.max()),
+    }
+
+
+class BenchmarkGateway(BaseGateway):
+    """
+    Gateway without any connection, only used for pushing data.
+    """
+
+    default_name: str = "BENCH"
+
+    def connect(self, setting: dict) -> None:
+        """"""
+        pass
+
+    def close(self) -> None:
+        """"""
+        pass
+
+    def subscribe(self, req) -> None:
+        """"""
+        pass
+
+    def send_order(self, req) -> str:
+        """"""
+        return ""
+
+    def cancel_order(self, req) -> None:
+        """"""
+        pass
+
+    def query_account(self) -> None:
+        """"""
+        pass
+
+    def query_position(self) -> None:
+        """"""
+        pass
+
+
+def create_ticks(count: int, interval: float = 0.5) -> List[TickData]:
+    """
+    Create ticks with random walk price.
+    """
+    rng: random.Random = random.Random(SEED)
+    dt: datetime = datetime(2024, 1, 2, 9, 0)
+    price: float = 3500
+    volume: float = 0
+
+    ticks: List[TickData] = []
+    for _ in range(count):
+        price += rng.choice((-1, 0, 1))
+        volume += rng.randint(1, 10)
+        dt += timedelta(seconds=interval)
+
+        tick: TickData = TickData(
+            symbol="rb2405",
+            exchange=Exchange.SHFE,
+            datetime=dt,
+            gateway_name="BENCH",
+            last_price=price,
+            volume=volume,
+            turnover=volume * price * 10,
+            open_interest=100000,
+            bid_price_1=price - 1,
+            ask_price_1=price + 1,
+            bid_volume_1=10,
+            ask_volume_1=10
+        )
+        ticks.append(tick)
+
+    return ticks
+
+
+def create_bars(count: int) -> List[BarData]:
+    """
+    Create minute bars with random walk price.
+    """
+    rng: random.Random = random.Random(SEED)
+    dt: datetime = datetime(2024, 1, 2, 9, 0)
+    price: float = 3500
+
+    bars: List[BarData] = []
+    for _ in range(count):
+        open_price: float = price
+        price += rng.uniform(-5, 5)
+        dt += timedelta(minutes=1)
+
+        bar: BarData = BarData(
+            symbol="rb2405",
+            exchange=Exchange.SHFE,
+            datetime=dt,
+            interval=Interval.MINUTE,
+            gateway_name="BENCH",
+            open_price=open_price,
+            high_price=max(open_price, price) + rng.uniform(0, 3),
+            low_price=min(open_price, price) - rng.uniform(0, 3),
+            close_price=price,
+            volume=rng.randint(100, 1000),
+            turnover=price * 1000,
+            open_interest=100000
+        )
+        bars.append(bar)
+
+    return bars
+
+
+def create_contract() -> ContractData:
+    """"""
+    return ContractData(
+        symbol="rb2405",
+        exchange=Exchange.SHFE,
+        name="rb2405",
+        product=Product.FUTURES,
+        size=10,
+        pricetick=1,
+        gateway_name="BENCH"
+    )
+
+
+@benchmark("event_engine.put")
+def run_event_put(scale: float) -> dict:
+    """
+    Put events into queue of event engine not started.
+    """
+    event_engine: EventEngine = EventEngine()
+    event: Event = Event(EVENT_TICK, None)
+
+    return measure(lambda: event_engine.put(event), int(100_000 * scale))
+
+
+@benchmark("event_engine.dispatch")
+def run_event_dispatch(scale: float) -> dict:
+    """
+    Throughput and latency from put until handler called, with event
+    engine thread running.
+    """
+    count: int = int(200_000 * scale)
+    latencies: List[int] = []
+    finished: TEvent = TEvent()
+
+    def process(event: Event) -> None:
+        latencies.append(perf_counter_ns() - event.data)
+        if len(latencies) >= count:
+            finished.set()
+
+    event_engine: EventEngine = EventEngine()
+    event_engine.register(EVENT_TICK, process)
+    event_engine.start()
+
+    start: int = perf_counter_ns()
+    for _ in range(count):
+        event_engine.put(Event(EVENT_TICK, perf_counter_ns()))
+    finished.wait()
+    end: int = perf_counter_ns()
+
+    event_engine.stop()
+
+    result: dict = {"events": count, "events_per_sec": round(count / (end - start) * 1e9, 1)}
+    result.update(get_percentiles(latencies))
+    return result
+
+
+@benchmark("event_engine.latency")
+def run_event_latency(scale: float) -> dict:
+    """
+    Latency of events put one by one with idle event engine.
+    """
+    count: int = int(5_000 * scale)
+    latencies: List[int] = []
+    received: TEvent = TEvent()
+
+    def process(event: Event) -> None:
+        latencies.append(perf_counter_ns() - event.data)
+        received.set()
+
+    event_engine: EventEngine = EventEngine()
+    event_engine.register(EVENT_TICK, process)
+    event_engine.start()
+
+    for _ in range(count):
+        received.clear()
+        event_engine.put(Event(EVENT_TICK, perf_counter_ns()))
+        received.wait()
+
+    event_engine.stop()
+
+    return get_percentiles(latencies)
+
+
+@benchmark("gateway.on_tick")
+def run_gateway_on_tick(scale: float) -> dict:
+    """
+    Fan out tick into general and symbol specific events.
+    """
+    event_engine: EventEngine = EventEngine()
+    gateway: BenchmarkGateway = BenchmarkGateway(event_engine, "BENCH")
+    tick: TickData = create_ticks(1)[0]
+
+    return measure(lambda: gateway.on_tick(tick), int(100_000 * scale))
+
+
+def create_oms_engine() -> OmsEngine:
+    """
+    Create OMS engine with a stand-in main engine.
+    """
+    main_engine: SimpleNamespace = SimpleNamespace()
+    oms_engine: OmsEngine = OmsEngine(main_engine, EventEngine())
+
+    oms_engine.process_contract_event(Event("", create_contract()))
+    return oms_engine
+
+
+@benchmark("oms_engine.process_tick_event")
+def run_oms_tick(scale: float) -> dict:
+    """"""
+    oms_engine: OmsEngine = create_oms_engine()
+    event: Event = Event(EVENT_TICK, create_ticks(1)[0])
+
+    return measure(lambda: oms_engine.process_tick_event(event), int(200_000 * scale))
+
+
+@benchmark("oms_engine.process_order_event")
+def run_oms_order(scale: float) -> dict:
+    """"""
+    oms_engine: OmsEngine = create_oms_engine()
+
+    order: OrderData = OrderData(
+        symbol="rb2405",
+        exchange=Exchange.SHFE,
+        orderid="1",
+        direction=Direction.SHORT,
+        offset=Offset.CLOSE,
+        price=3500,
+        volume=10,
+        status=Status.NOTTRADED,
+        gateway_name="BENCH"
+    )
+    event: Event = Event("", order)
+
+    return measure(lambda: oms_engine.process_order_event(event), int(100_000 * scale))
+
+
+@benchmark("oms_engine.process_trade_event")
+def run_oms_trade(scale: float) -> dict:
+    """"""
+    oms_engine: OmsEngine = create_oms_engine()
+
+    trade: TradeData = TradeData(
+        symbol="rb2405",
+        exchange=Exchange.SHFE,
+        orderid="1",
+        tradeid="1",
+        direction=Direction.LONG,
+        offset=Offset.OPEN,
+        price=3500,
+        volume=1,
+        gateway_name="BENCH"
+    )
+    event: Event = Event("", trade)
+
+    return measure(lambda: oms_engine.process_trade_event(event), int(100_000 * scale))
+
+
+@benchmark("oms_engine.process_position_event")
+def run_oms_position(scale: float) -> dict:
+    """"""
+    oms_engine: OmsEngine = create_oms_engine()
+
+    position: PositionData = PositionData(
+        symbol="rb2405",
+        exchange=Exchange.SHFE,
+        direction=Direction.LONG,
+        volume=10,
+        yd_volume=5,
+        gateway_name="BENCH"
+    )
+    event: Event = Event("", position)
+
+    return measure(lambda: oms_engine.process_position_event(event), int(100_000 * scale))
+
+
+@benchmark("position_holding.update_trade")
+def run_holding_trade(scale: float) -> dict:
+    """"""
+    holding: PositionHolding = PositionHolding(create_contract())
+
+    trade: TradeData = TradeData(
+        symbol="rb2405",
+        exchange=Exchange.SHFE,
+        orderid="1",
+        tradeid="1",
+        direction=Direction.LONG,
+        offset=Offset.OPEN,
+        price=3500,
+        volume=1,
+        gateway_name="BENCH"
+    )
+
+    return measure(lambda: holding.update_trade(trade), int(200_000 * scale))
+
+
+@benchmark("position_holding.calculate_frozen")
+def run_holding_frozen(scale: float) -> dict:
+    """
+    Calculate frozen volume with 100 active close orders.
+    """
+    holding: PositionHolding = PositionHolding(create_contract())
+    holding.long_td = holding.long_pos = 1000
+    holding.short_yd = holding.short_pos = 1000
+
+    for i in range(100):
+        order: OrderData = OrderData(
+            symbol="rb2405",
+            exchange=Exchange.SHFE,
+            orderid=str(i),
+            direction=Direction.SHORT if i % 2 else Direction.LONG,
+            offset=Offset.CLOSE if i % 3 else Offset.CLOSETODAY,
+            price=3500,
+            volume=5,
+            status=Status.NOTTRADED,
+            gateway_name="BENCH"
+        )
+        holding.active_orders[order.vt_orderid] = order
+
+    return measure(holding.calculate_frozen, int(20_000 * scale))
+
+
+@benchmark("bar_generator.update_tick")
+def run_bar_generator(scale: float) -> dict:
+    """"""
+    n: int = int(50_000 * scale)
+
+    # Ticks must keep moving forward for all repeats
+    ticks: List[TickData] = create_ticks(n * 5 + 1000)
+    bar_generator: BarGenerator = BarGenerator(lambda bar: None)
+
+    tick_iter = iter(ticks)
+    return measure(lambda: bar_generator.update_tick(next(tick_iter)), n)
+
+
+@benchmark("array_manager.update_bar")
+def run_array_manager(scale: float) -> dict:
+    """"""
+    n: int = int(50_000 * scale)
+
+    bars: List[BarData] = create_bars(n * 5 + 1000)
+    array_manager: ArrayManager = ArrayManager(100)
+
+    bar_iter = iter(bars)
+    return measure(lambda: array_manager.update_bar(next(bar_iter)), n)
+
+
+@benchmark("array_manager.indicators")
+def run_indicators(scale: float) -> dict:
+    """
+    Time of each indicator calculated on full array manager.
+    """
+    array_manager: ArrayManager = ArrayManager(100)
+    for bar in create_bars(100):
+        array_manager.update_bar(bar)
+
+    indicators: Dict[str, Callable] = {
+        "sma": lambda: array_manager.sma(20),
+        "ema": lambda: array_manager.ema(20),
+        "std": lambda: array_manager.std(20),
+        "atr": lambda: array_manager.atr(14),
+        "rsi": lambda: array_manager.rsi(14),
+        "cci": lambda: array_manager.cci(20),
+        "adx": lambda: array_manager.adx(14),
+        "macd": lambda: array_manager.macd(12, 26, 9),
+        "boll": lambda: array_manager.boll(20, 2),
+        "keltner": lambda: array_manager.keltner(20, 2),
+        "donchian": lambda: array_manager.donchian(20),
+    }
+
+    n: int = int(10_000 * scale)
+    return {name: measure(func, n) for name, func in indicators.items()}
+
+
+@benchmark("bar_manager.get_price_range")
+def run_bar_manager(scale: float) -> dict:
+    """
+    Price range of random windows in 10000 bars without cache.
+    """
+    from vnpy.chart.manager import BarManager
+
+    bar_manager: BarManager = BarManager()
+    bar_manager.update_history(create_bars(10_000))
+
+    rng: random.Random = random.Random(SEED)
+    windows: List[tuple] = []
+    for _ in range(1000):
+        min_ix: int = rng.randint(0, 9000)
+        windows.append((min_ix, min_ix + rng.randint(50, 1000)))
+
+    window_iter = iter(windows * 1000)
+
+    def get_price_range() -> None:
+        bar_manager._price_ranges.clear()
+        bar_manager.get_price_range(*next(window_iter))
+
+    return measure(get_price_range, int(10_000 * scale))
+
+
+class BenchmarkServer(RpcServer):
+    """
+    Rpc server replying data received.
+    """
+
+    def __init__(self) -> None:
+        """"""
+        super().__init__()
+
+        self.register(self.echo)
+
+    def echo(self, data: object) -> object:
+        """"""
+        return data
+
+
+class BenchmarkClient(RpcClient):
+    """
+    Rpc client ignoring data published.
+    """
+
+    def callback(self, topic: str, data: object) -> None:
+        """"""
+        pass
+
+
+def get_free_port() -> int:
+    """
+    Get a local tcp port not in use.
+    """
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+@benchmark("rpc.round_trip")
+def run_rpc(scale: float) -> dict:
+    """
+    Round trip latency of request and reply through local tcp.
+    """
+    rep_address: str = f"tcp://127.0.0.1:{get_free_port()}"
+    pub_address: str = f"tcp://127.0.0.1:{get_free_port()}"
+
+    server: BenchmarkServer = BenchmarkServer()
+    server.start(rep_address, pub_address)
+
+    client: BenchmarkClient = BenchmarkClient()
+    client.subscribe_topic("")
+    client.start(rep_address, pub_address)
+
+    tick: TickData = create_ticks(1)[0]
+    latencies: List[int] = []
+
+    try:
+        for _ in range(int(5_000 * scale)):
+            start: int = perf_counter_ns()
+            client.echo(tick)
+            latencies.append(perf_counter_ns() - start)
+    finally:
+        # Client is stopped first, and woken from polling by data published
+        # while server is still alive
+        client.stop()
+        server.publish("stop", None)
+        client.join()
+
+        server.stop()
+        server.join()
+
+    return get_percentiles(latencies)
+
+
+def run_with_timeout(func: Callable, scale: float, timeout: float) -> dict:
+    """
+    Run benchmark in a daemon thread, result is error message if it
+    raised exception or did not finish within timeout.
+    """
+    result: dict = {}
+
+    def run() -> None:
+        try:
+            result.update(func(scale))
+        except Exception as ex:
+            result["error"] = repr(ex)
+
+    thread: Thread = Thread(target=run, daemon=True)
+    thread.start()
+    thread.join(timeout)
+
+    if thread.is_alive():
+        return {"error": f"timeout after {timeout} seconds"}
+    return result
+
+
+def main() -> None:
+    """"""
+    parser: argparse.ArgumentParser = argparse.ArgumentParser()
+    parser.add_argument("--output", default="", help="path of JSON result file")
+    parser.add_argument("--filter", default="", help="only run benchmarks with name containing text")
+    parser.add_argument("--scale", type=float, default=1.0, help="scale of iteration counts")
+    parser.add_argument("--timeout", type=float, default=600, help="seconds before a benchmark fails")
+    args: argparse.Namespace = parser.parse_args()
+
+    random.seed(SEED)
+    np.random.seed(SEED)
+
+    results: dict = {}
+    for name, func in BENCHMARKS.items():
+        if args.filter and args.filter not in name:
+            continue
+
+        result: dict = run_with_timeout(func, args.scale, args.timeout)
+        results[name] = result
+        print(name, json.dumps(result, ensure_ascii=False))
+
+    report: dict = {
+        "meta": {
+            "vnpy": __version__,
+            "python": sys.version.split()[0],
+            "platform": platform.platform(),
+            "processor": platform.processor(),
+            "datetime": datetime.now().isoformat(),
+            "scale": args.scale,
+        },
+        "results": results,
+    }
+
+    output: str = args.output or f"benchmark_{datetime.now().strftime('%Y%m%d_%H%M%S')}.json"
+    with open(output, "w", encoding="utf8") as f:
+        json.dump(report, f, indent=4, ensure_ascii=False)
+
+    print(f"Results saved into {output}")
+
+
+if __name__ == "__main__":
+    main()
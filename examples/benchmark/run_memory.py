@@ -0,0 +1,427 @@
+"""
+Memory footprint and allocation profiling of trading platform.
+
+Synthetic ticks and orders are driven through MainEngine with OmsEngine
+and data monitors attached, while memory is traced with tracemalloc.
+Report is printed and saved into a JSON file, including:
+    * retained bytes per TickData/OrderData/BarData object
+    * retained/peak bytes and blocks per tick and per order event
+    * growth curves of OmsEngine and LocalOrderManager maps
+    * top allocation sites and object types retained
+
+Usage:
+    python run_memory.py [--output result.json] [--ticks 100000] [--orders 50000] [--no-ui]
+"""
+
+import argparse
+import gc
+import json
+import platform
+import sys
+import tracemalloc
+from collections import Counter
+from copy import copy
+from datetime import datetime, timedelta
+from threading import Event as TEvent
+from typing import Callable, Dict, List
+
+from vnpy import __version__
+from vnpy.event import Event, EventEngine
+from vnpy.trader.constant import Direction, Exchange, Interval, Offset, OrderType, Product, Status
+from vnpy.trader.engine import MainEngine, OmsEngine
+from vnpy.trader.gateway import BaseGateway, LocalOrderManager
+from vnpy.trader.object import (
+    BarData,
+    CancelRequest,
+    ContractData,
+    OrderData,
+    OrderRequest,
+    SubscribeRequest,
+    TickData,
+    TradeData
+)
+
+
+EVENT_FLUSH: str = "eMemoryFlush"
+
+SYMBOL_COUNT: int = 100
+STEP_COUNT: int = 10
+
+
+class MemoryGateway(BaseGateway):
+    """
+    Gateway filling every order immediately, with local order id
+    managed by LocalOrderManager like real gateways.
+    """
+
+    default_name: str = "MEMORY"
+
+    exchanges: List[Exchange] = [Exchange.SHFE]
+
+    def __init__(self, event_engine: EventEngine, gateway_name: str) -> None:
+        """"""
+        super().__init__(event_engine, gateway_name)
+
+        self.order_manager: LocalOrderManager = LocalOrderManager(self)
+        self.trade_count: int = 0
+
+    def connect(self, setting: dict) -> None:
+        """"""
+        pass
+
+    def close(self) -> None:
+        """"""
+        pass
+
+    def subscribe(self, req: SubscribeRequest) -> None:
+        """"""
+        pass
+
+    def send_order(self, req: OrderRequest) -> str:
+        """"""
+        local_orderid: str = self.order_manager.new_local_orderid()
+        self.order_manager.update_orderid_map(local_orderid, f"sys{local_orderid}")
+
+        order: OrderData = req.create_order_data(local_orderid, self.gateway_name)
+        order.status = Status.NOTTRADED
+        self.order_manager.on_order(order)
+
+        self.trade_count += 1
+        trade: TradeData = TradeData(
+            symbol=order.symbol,
+            exchange=order.exchange,
+            orderid=order.orderid,
+            tradeid=str(self.trade_count),
+            direction=order.direction,
+            offset=order.offset,
+            price=order.price,
+            volume=order.volume,
+            datetime=datetime.now(),
+            gateway_name=self.gateway_name
+        )
+
+        order = copy(order)
+        order.traded = order.volume
+        order.status = Status.ALLTRADED
+        self.order_manager.on_order(order)
+        self.on_trade(trade)
+
+        return order.vt_orderid
+
+    def cancel_order(self, req: CancelRequest) -> None:
+        """"""
+        pass
+
+    def query_account(self) -> None:
+        """"""
+        pass
+
+    def query_position(self) -> None:
+        """"""
+        pass
+
+
+class MemoryHarness:
+    """
+    Drive synthetic data through main engine and trace memory usage.
+    """
+
+    def __init__(self, ui: bool) -> None:
+        """"""
+        self.qapp = None
+        self.monitors: list = []
+
+        self.event_engine: EventEngine = EventEngine()
+        self.main_engine: MainEngine = MainEngine(self.event_engine)
+
+        self.gateway: MemoryGateway = self.main_engine.add_gateway(MemoryGateway)
+        self.oms_engine: OmsEngine = self.main_engine.get_engine("oms")
+
+        self.flushed: TEvent = TEvent()
+        self.event_engine.register(EVENT_FLUSH, lambda event: self.flushed.set())
+
+        if ui:
+            self.init_ui()
+
+        self.init_contracts()
+
+    def init_ui(self) -> None:
+        """
+        Create data monitors of main window.
+        """
+        from vnpy.trader.ui import QtWidgets
+        from vnpy.trader.ui.widget import (
+            TickMonitor,
+            OrderMonitor,
+            ActiveOrderMonitor,
+            TradeMonitor,
+            PositionMonitor,
+            LogMonitor
+        )
+
+        self.qapp = QtWidgets.QApplication.instance() or QtWidgets.QApplication(sys.argv)
+
+        for monitor_class in [
+            TickMonitor,
+            OrderMonitor,
+            ActiveOrderMonitor,
+            TradeMonitor,
+            PositionMonitor,
+            LogMonitor
+        ]:
+            self.monitors.append(monitor_class(self.main_engine, self.event_engine))
+
+    def init_contracts(self) -> None:
+        """"""
+        contracts: List[ContractData] = [
+            ContractData(
+                symbol=f"rb{i}",
+                exchange=Exchange.SHFE,
+                name=f"rb{i}",
+                product=Product.FUTURES,
+                size=10,
+                pricetick=1,
+                gateway_name=self.gateway.gateway_name
+            )
+            for i in range(SYMBOL_COUNT)
+        ]
+        self.gateway.on_contracts(contracts)
+        self.flush()
+
+    def flush(self) -> None:
+        """
+        Wait until all events put are processed and monitors refreshed.
+        """
+        self.flushed.clear()
+        self.event_engine.put(Event(EVENT_FLUSH))
+        self.flushed.wait()
+
+        if self.qapp:
+            for monitor in self.monitors:
+                if hasattr(monitor, "refresh_table"):
+                    monitor.refresh_table()
+            self.qapp.processEvents()
+
+    def close(self) -> None:
+        """"""
+        self.main_engine.close()
+
+        for monitor in self.monitors:
+            monitor.close()
+
+    def push_ticks(self, count: int, start: int) -> None:
+        """"""
+        dt: datetime = datetime(2024, 1, 2, 9, 0)
+
+        for i in range(start, start + count):
+            tick: TickData = TickData(
+                symbol=f"rb{i % SYMBOL_COUNT}",
+                exchange=Exchange.SHFE,
+                datetime=dt + timedelta(milliseconds=500 * i),
+                gateway_name=self.gateway.gateway_name,
+                last_price=3500 + i % 10,
+                volume=i,
+                bid_price_1=3499,
+                ask_price_1=3501
+            )
+            self.gateway.on_tick(tick)
+
+            # Avoid event queue growing too large
+            if not i % 1000:
+                self.flush()
+
+        self.flush()
+
+    def send_orders(self, count: int) -> None:
+        """"""
+        for i in range(count):
+            req: OrderRequest = OrderRequest(
+                symbol=f"rb{i % SYMBOL_COUNT}",
+                exchange=Exchange.SHFE,
+                direction=Direction.LONG if i % 2 else Direction.SHORT,
+                type=OrderType.LIMIT,
+                volume=1,
+                price=3500,
+                offset=Offset.OPEN
+            )
+            self.main_engine.send_order(req, self.gateway.gateway_name)
+
+            if not i % 1000:
+                self.flush()
+
+        self.flush()
+
+    def measure(self, func: Callable, count: int) -> dict:
+        """
+        Measure retained and peak memory of running func for count events.
+        """
+        gc.collect()
+        tracemalloc.reset_peak()
+
+        start_size: int = tracemalloc.get_traced_memory()[0]
+        start_blocks: int = sys.getallocatedblocks()
+
+        func()
+
+        current, peak = tracemalloc.get_traced_memory()
+        gc.collect()
+        retained: int = tracemalloc.get_traced_memory()[0] - start_size
+        blocks: int = sys.getallocatedblocks() - start_blocks
+
+        return {
+            "events": count,
+            "retained_bytes_per_event": round(retained / count, 1),
+            "retained_blocks_per_event": round(blocks / count, 2),
+            "peak_bytes_per_event": round((peak - start_size) / count, 1),
+            "transient_bytes_per_event": round((peak - current) / count, 1),
+        }
+
+    def get_map_sizes(self) -> dict:
+        """
+        Get length of maps growing with orders.
+        """
+        order_manager: LocalOrderManager = self.gateway.order_manager
+
+        return {
+            "oms.orders": len(self.oms_engine.orders),
+            "oms.trades": len(self.oms_engine.trades),
+            "oms.active_orders": len(self.oms_engine.active_orders),
+            "local.orders": len(order_manager.orders),
+            "local.local_sys_orderid_map": len(order_manager.local_sys_orderid_map),
+            "local.sys_local_orderid_map": len(order_manager.sys_local_orderid_map),
+        }
+
+    def run_order_growth(self, count: int) -> List[dict]:
+        """
+        Send orders in steps and record map sizes and memory of each step.
+        """
+        curve: List[dict] = []
+        step: int = max(count // STEP_COUNT, 1)
+
+        for i in range(STEP_COUNT):
+            self.send_orders(step)
+            gc.collect()
+
+            point: dict = {"orders_sent": step * (i + 1)}
+            point.update(self.get_map_sizes())
+            point["traced_mb"] = round(tracemalloc.get_traced_memory()[0] / 1024 / 1024, 3)
+            curve.append(point)
+
+        return curve
+
+
+def measure_objects(create: Callable, count: int = 10000) -> dict:
+    """
+    Measure retained bytes of each object created.
+    """
+    gc.collect()
+    start: int = tracemalloc.get_traced_memory()[0]
+
+    objects: list = [create(i) for i in range(count)]
+
+    size: int = tracemalloc.get_traced_memory()[0] - start - sys.getsizeof(objects)
+    del objects
+
+    return {"bytes_per_object": round(size / count, 1)}
+
+
+def get_object_types(top: int = 20) -> Dict[str, dict]:
+    """
+    Get types of objects tracked by gc with most instances.
+    """
+    counts: Counter = Counter()
+    sizes: Counter = Counter()
+
+    for obj in gc.get_objects():
+        name: str = type(obj).__qualname__
+        counts[name] += 1
+        sizes[name] += sys.getsizeof(obj)
+
+    return {
+        name: {"count": count, "shallow_bytes": sizes[name]}
+        for name, count in counts.most_common(top)
+    }
+
+
+def get_max_rss() -> int:
+    """
+    Get max resident set size in bytes, 0 if not supported.
+    """
+    try:
+        import resource
+    except ImportError:
+        return 0
+
+    rss: int = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return rss if sys.platform == "darwin" else rss * 1024
+
+
+def main() -> None:
+    """"""
+    parser: argparse.ArgumentParser = argparse.ArgumentParser()
+    parser.add_argument("--output", default="", help="path of JSON result file")
+    parser.add_argument("--ticks", type=int, default=100_000, help="number of ticks pushed")
+    parser.add_argument("--orders", type=int, default=50_000, help="number of orders sent")
+    parser.add_argument("--no-ui", action="store_true", help="run without data monitors")
+    parser.add_argument("--frames", type=int, default=1, help="traceback frames kept by tracemalloc")
+    args: argparse.Namespace = parser.parse_args()
+
+    tracemalloc.start(args.frames)
+
+    dt: datetime = datetime(2024, 1, 2, 9, 0)
+    objects: dict = {
+        "TickData": measure_objects(lambda i: TickData(
+            "MEMORY", f"rb{i}", Exchange.SHFE, dt, last_price=3500.0 + i
+        )),
+        "OrderData": measure_objects(lambda i: OrderData(
+            "MEMORY", f"rb{i}", Exchange.SHFE, str(i), price=3500.0 + i, volume=1
+        )),
+        "BarData": measure_objects(lambda i: BarData(
+            "MEMORY", f"rb{i}", Exchange.SHFE, dt, Interval.MINUTE, close_price=3500.0 + i
+        )),
+    }
+
+    harness: MemoryHarness = MemoryHarness(not args.no_ui)
+    baseline: tracemalloc.Snapshot = tracemalloc.take_snapshot()
+
+    try:
+        ticks: dict = harness.measure(lambda: harness.push_ticks(args.ticks, 0), args.ticks)
+        orders: dict = harness.measure(lambda: harness.send_orders(args.orders), args.orders)
+        growth: List[dict] = harness.run_order_growth(args.orders)
+
+        snapshot: tracemalloc.Snapshot = tracemalloc.take_snapshot()
+        sites: List[dict] = [
+            {"site": str(stat.traceback), "size_diff": stat.size_diff, "count_diff": stat.count_diff}
+            for stat in snapshot.compare_to(baseline, "lineno")[:20]
+        ]
+        types: Dict[str, dict] = get_object_types()
+    finally:
+        harness.close()
+
+    report: dict = {
+        "meta": {
+            "vnpy": __version__,
+            "python": sys.version.split()[0],
+            "platform": platform.platform(),
+            "datetime": datetime.now().isoformat(),
+            "ui": not args.no_ui,
+        },
+        "objects": objects,
+        "events": {"tick": ticks, "order": orders},
+        "growth": growth,
+        "allocation_sites": sites,
+        "object_types": types,
+        "max_rss_mb": round(get_max_rss() / 1024 / 1024, 1),
+    }
+
+    print(json.dumps({k: report[k] for k in ["objects", "events", "max_rss_mb"]}, indent=4))
+
+    output: str = args.output or f"memory_{datetime.now().strftime('%Y%m%d_%H%M%S')}.json"
+    with open(output, "w", encoding="utf8") as f:
+        json.dump(report, f, indent=4, ensure_ascii=False)
+
+    print(f"Results saved into {output}")
+
+
+if __name__ == "__main__":
+    main()
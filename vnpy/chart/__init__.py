@@ -1,2 +1,2 @@
 from .widget import ChartWidget
-from .item import CandleItem, VolumeItem
+from .item import CandleItem, VolumeItem, TradeItem, OrderItem
@@ -12,6 +12,9 @@ CURSOR_COLOR = (255, 245, 162)
 PEN_WIDTH = 1
 BAR_WIDTH = 0.3
 
+MARKER_SIZE = 6             # Marker size in pixels
+MARKER_INFO_COUNT = 5       # Max markers shown in cursor info
+
 AXIS_WIDTH = 0.8
 NORMAL_FONT = QtGui.QFont("Arial", 9)
 
@@ -1,17 +1,26 @@
 from abc import abstractmethod
-from typing import List, Dict, Tuple
+from datetime import datetime
+from typing import Any, List, Dict, Tuple
 
+import numpy as np
 import pyqtgraph as pg
 
 from vnpy.trader.ui import QtCore, QtGui, QtWidgets
-from vnpy.trader.object import BarData
+from vnpy.trader.object import BarData, OrderData, TradeData
+from vnpy.trader.constant import Direction
 
-from .base import BLACK_COLOR, UP_COLOR, DOWN_COLOR, PEN_WIDTH, BAR_WIDTH
+from .base import (
+    BLACK_COLOR, UP_COLOR, DOWN_COLOR, PEN_WIDTH, BAR_WIDTH,
+    MARKER_SIZE, MARKER_INFO_COUNT
+)
 from .manager import BarManager
 
 
-class ChartItem(pg.GraphicsObject):
-    """"""
+class PictureItem(pg.GraphicsObject):
+    """
+    Base item caching drawing of visible area into one picture, which is
+    only redrawn when visible area changed or data updated.
+    """
 
     def __init__(self, manager: BarManager) -> None:
         """"""
@@ -19,8 +28,7 @@ class ChartItem(pg.GraphicsObject):
 
         self._manager: BarManager = manager
 
-        self._bar_picutures: Dict[int, QtGui.QPicture] = {}
-        self._item_picuture: QtGui.QPicture = None
+        self._item_picture: QtGui.QPicture = None
 
         self._black_brush: QtGui.QBrush = pg.mkBrush(color=BLACK_COLOR)
 
@@ -34,7 +42,7 @@ class ChartItem(pg.GraphicsObject):
         )
         self._down_brush: QtGui.QBrush = pg.mkBrush(color=DOWN_COLOR)
 
-        self._rect_area: Tuple[float, float] = None
+        self._rect_area: tuple = None
 
         # Very important! Only redraw the visible part and improve speed a lot.
         self.setFlag(self.ItemUsesExtendedStyleOption)
@@ -42,6 +50,62 @@ class ChartItem(pg.GraphicsObject):
         # Force update during the next paint
         self._to_update: bool = False
 
+    @abstractmethod
+    def _get_rect_area(self, rect: QtCore.QRectF) -> tuple:
+        """
+        Get parameters of visible area, which are passed to
+        _draw_item_picture when changed.
+        """
+        pass
+
+    @abstractmethod
+    def _draw_item_picture(self, *args) -> None:
+        """
+        Draw the picture of item in visible area.
+        """
+        pass
+
+    def update(self) -> None:
+        """
+        Refresh the item.
+        """
+        if self.scene():
+            self._to_update = True
+            self.scene().update()
+
+    def paint(
+        self,
+        painter: QtGui.QPainter,
+        opt: QtWidgets.QStyleOptionGraphicsItem,
+        w: QtWidgets.QWidget
+    ) -> None:
+        """
+        Reimplement the paint method of parent class.
+
+        This function is called by external QGraphicsView.
+        """
+        rect_area: tuple = self._get_rect_area(opt.exposedRect)
+        if (
+            self._to_update
+            or rect_area != self._rect_area
+            or not self._item_picture
+        ):
+            self._to_update = False
+            self._rect_area = rect_area
+            self._draw_item_picture(*rect_area)
+
+        self._item_picture.play(painter)
+
+
+class ChartItem(PictureItem):
+    """"""
+
+    def __init__(self, manager: BarManager) -> None:
+        """"""
+        super().__init__(manager)
+
+        self._bar_picutures: Dict[int, QtGui.QPicture] = {}
+
     @abstractmethod
     def _draw_bar_picture(self, ix: int, bar: BarData) -> QtGui.QPicture:
         """
@@ -94,49 +158,19 @@ class ChartItem(pg.GraphicsObject):
 
         self.update()
 
-    def update(self) -> None:
-        """
-        Refresh the item.
-        """
-        if self.scene():
-            self._to_update = True
-            self.scene().update()
-
-    def paint(
-        self,
-        painter: QtGui.QPainter,
-        opt: QtWidgets.QStyleOptionGraphicsItem,
-        w: QtWidgets.QWidget
-    ) -> None:
-        """
-        Reimplement the paint method of parent class.
-
-        This function is called by external QGraphicsView.
-        """
-        rect = opt.exposedRect
-
+    def _get_rect_area(self, rect: QtCore.QRectF) -> tuple:
+        """"""
         min_ix: int = int(rect.left())
         max_ix: int = int(rect.right())
         max_ix: int = min(max_ix, len(self._bar_picutures))
-
-        rect_area: tuple = (min_ix, max_ix)
-        if (
-            self._to_update
-            or rect_area != self._rect_area
-            or not self._item_picuture
-        ):
-            self._to_update = False
-            self._rect_area = rect_area
-            self._draw_item_picture(min_ix, max_ix)
-
-        self._item_picuture.play(painter)
+        return min_ix, max_ix
 
     def _draw_item_picture(self, min_ix: int, max_ix: int) -> None:
         """
         Draw the picture of item in specific range.
         """
-        self._item_picuture = QtGui.QPicture()
-        painter: QtGui.QPainter = QtGui.QPainter(self._item_picuture)
+        self._item_picture = QtGui.QPicture()
+        painter: QtGui.QPainter = QtGui.QPainter(self._item_picture)
 
         for ix in range(min_ix, max_ix):
             bar_picture: QtGui.QPicture = self._bar_picutures[ix]
@@ -154,7 +188,7 @@ class ChartItem(pg.GraphicsObject):
         """
         Clear all data in the item.
         """
-        self._item_picuture = None
+        self._item_picture = None
         self._bar_picutures.clear()
         self.update()
 
@@ -325,3 +359,295 @@ class VolumeItem(ChartItem):
             text: str = ""
 
         return text
+
+
+class MarkerItem(PictureItem):
+    """
+    Base item for drawing order/trade markers onto bar chart.
+
+    Markers are stored in numpy arrays sorted by time, so both visible
+    range culling and cursor hit-testing only need binary search.
+    """
+
+    marker_filled: bool = True
+
+    def __init__(self, manager: BarManager) -> None:
+        """"""
+        super().__init__(manager)
+
+        self._datas: Dict[str, Any] = {}
+        self._bar_times: np.ndarray = np.empty(0)
+
+        self._keys: List[str] = []
+        self._times: np.ndarray = np.empty(0)
+        self._ixs: np.ndarray = np.empty(0, dtype=int)
+        self._prices: np.ndarray = np.empty(0)
+        self._longs: np.ndarray = np.empty(0, dtype=bool)
+
+    @abstractmethod
+    def get_marker_key(self, data: Any) -> str:
+        """
+        Get unique key of marker data.
+        """
+        pass
+
+    @abstractmethod
+    def get_marker_text(self, data: Any) -> str:
+        """
+        Get information text of marker data.
+        """
+        pass
+
+    def update_markers(self, datas: list) -> None:
+        """
+        Update a list of marker data.
+
+        New markers later than all existing ones are appended, arrays
+        are only sorted again when new markers are out of order.
+        """
+        new_datas: list = []
+
+        for data in datas:
+            if not data.datetime or not data.price:
+                continue
+
+            key: str = self.get_marker_key(data)
+            if key not in self._datas:
+                new_datas.append(data)
+            self._datas[key] = data
+
+        if new_datas:
+            new_datas.sort(key=lambda d: d.datetime.timestamp())
+            first_time: float = new_datas[0].datetime.timestamp()
+
+            if not len(self._times) or first_time >= self._times[-1]:
+                self._append_markers(new_datas)
+            else:
+                self._sort_markers()
+
+        self.update()
+
+    def _append_markers(self, datas: list) -> None:
+        """
+        Append markers sorted by datetime to the end of arrays.
+        """
+        times: np.ndarray = np.array([d.datetime.timestamp() for d in datas], dtype=float)
+        prices: np.ndarray = np.array([d.price for d in datas], dtype=float)
+        longs: np.ndarray = np.array([d.direction != Direction.SHORT for d in datas], dtype=bool)
+        ixs: np.ndarray = np.searchsorted(self._bar_times, times, side="right") - 1
+
+        self._keys.extend(self.get_marker_key(d) for d in datas)
+        self._times = np.concatenate([self._times, times])
+        self._prices = np.concatenate([self._prices, prices])
+        self._longs = np.concatenate([self._longs, longs])
+        self._ixs = np.concatenate([self._ixs, ixs])
+
+    def _sort_markers(self) -> None:
+        """
+        Rebuild marker arrays sorted by datetime.
+        """
+        keys: List[str] = list(self._datas.keys())
+        datas: list = list(self._datas.values())
+
+        times: np.ndarray = np.array([d.datetime.timestamp() for d in datas], dtype=float)
+        prices: np.ndarray = np.array([d.price for d in datas], dtype=float)
+        longs: np.ndarray = np.array([d.direction != Direction.SHORT for d in datas], dtype=bool)
+
+        order: np.ndarray = np.argsort(times, kind="stable")
+
+        self._keys = [keys[i] for i in order]
+        self._times = times[order]
+        self._prices = prices[order]
+        self._longs = longs[order]
+
+        self._update_ixs()
+
+    def _update_ixs(self) -> None:
+        """
+        Map marker datetime to index of the bar which contains it.
+        """
+        self._ixs = np.searchsorted(self._bar_times, self._times, side="right") - 1
+
+    def update_history(self, history: List[BarData]) -> None:
+        """
+        Update a list of bar data.
+        """
+        bars: List[BarData] = self._manager.get_all_bars()
+        self._bar_times = np.array([bar.datetime.timestamp() for bar in bars], dtype=float)
+
+        self._update_ixs()
+        self.update()
+
+    def update_bar(self, bar: BarData) -> None:
+        """
+        Update single bar data.
+        """
+        ix: int = self._manager.get_index(bar.datetime)
+        if ix != len(self._bar_times):
+            return
+
+        bar_time: float = bar.datetime.timestamp()
+        self._bar_times = np.append(self._bar_times, bar_time)
+
+        # Only markers later than new bar need to be moved
+        start: int = np.searchsorted(self._times, bar_time, side="left")
+        if start < len(self._times):
+            self._ixs[start:] = ix
+            self.update()
+
+    def _get_rect_area(self, rect: QtCore.QRectF) -> tuple:
+        """"""
+        min_ix: int = int(rect.left())
+        max_ix: int = int(rect.right())
+
+        # Marker size is fixed in pixels, so redraw after zooming
+        half_width: float = self.pixelWidth() * MARKER_SIZE / 2
+        height: float = self.pixelHeight() * MARKER_SIZE
+
+        return min_ix, max_ix, half_width, height
+
+    def _draw_item_picture(
+        self,
+        min_ix: int,
+        max_ix: int,
+        half_width: float,
+        height: float
+    ) -> None:
+        """
+        Draw markers within visible range into one path for each direction.
+        """
+        self._item_picture = QtGui.QPicture()
+        painter: QtGui.QPainter = QtGui.QPainter(self._item_picture)
+
+        start: int = np.searchsorted(self._ixs, min_ix, side="left")
+        end: int = np.searchsorted(self._ixs, max_ix, side="right")
+
+        long_path: QtGui.QPainterPath = QtGui.QPainterPath()
+        short_path: QtGui.QPainterPath = QtGui.QPainterPath()
+
+        for ix, price, long in zip(
+            self._ixs[start:end].tolist(),
+            self._prices[start:end].tolist(),
+            self._longs[start:end].tolist()
+        ):
+            # Long marker points up from below, short marker points down from above
+            if long:
+                path: QtGui.QPainterPath = long_path
+                bottom: float = price - height
+            else:
+                path: QtGui.QPainterPath = short_path
+                bottom: float = price + height
+
+            path.addPolygon(QtGui.QPolygonF([
+                QtCore.QPointF(ix, price),
+                QtCore.QPointF(ix - half_width, bottom),
+                QtCore.QPointF(ix + half_width, bottom),
+            ]))
+            path.closeSubpath()
+
+        painter.setPen(self._up_pen)
+        painter.setBrush(self._up_brush if self.marker_filled else self._black_brush)
+        painter.drawPath(long_path)
+
+        painter.setPen(self._down_pen)
+        painter.setBrush(self._down_brush if self.marker_filled else self._black_brush)
+        painter.drawPath(short_path)
+
+        painter.end()
+
+    def boundingRect(self) -> QtCore.QRectF:
+        """"""
+        min_price, max_price = self._manager.get_price_range()
+        rect: QtCore.QRectF = QtCore.QRectF(
+            0,
+            min_price,
+            len(self._bar_times),
+            max_price - min_price
+        )
+        return rect
+
+    def get_y_range(self, min_ix: int = None, max_ix: int = None) -> Tuple[float, float]:
+        """
+        Get range of y-axis with given x-axis range.
+
+        Markers follow the price range of bars, so that far away orders
+        will not squeeze the candle chart.
+        """
+        min_price, max_price = self._manager.get_price_range(min_ix, max_ix)
+        return min_price, max_price
+
+    def get_info_text(self, ix: int) -> str:
+        """
+        Get information text of markers within the bar.
+        """
+        start: int = np.searchsorted(self._ixs, ix, side="left")
+        end: int = np.searchsorted(self._ixs, ix, side="right")
+
+        if start == end:
+            return ""
+
+        words: list = [
+            self.get_marker_text(self._datas[key])
+            for key in self._keys[start:min(end, start + MARKER_INFO_COUNT)]
+        ]
+
+        rest: int = end - start - MARKER_INFO_COUNT
+        if rest > 0:
+            words.append(f"... {rest} more")
+
+        text: str = "\n".join(words)
+        return text
+
+    def clear_all(self) -> None:
+        """
+        Clear all data in the item.
+        """
+        self._datas.clear()
+        self._bar_times = np.empty(0)
+
+        self._keys = []
+        self._times = np.empty(0)
+        self._ixs = np.empty(0, dtype=int)
+        self._prices = np.empty(0)
+        self._longs = np.empty(0, dtype=bool)
+
+        self._item_picture = None
+        self.update()
+
+
+class TradeItem(MarkerItem):
+    """"""
+
+    marker_filled: bool = True
+
+    def get_marker_key(self, data: TradeData) -> str:
+        """"""
+        return data.vt_tradeid
+
+    def get_marker_text(self, data: TradeData) -> str:
+        """"""
+        dt: datetime = data.datetime
+        text: str = (
+            f"Trade {dt.strftime('%H:%M:%S')} "
+            f"{data.direction.value}{data.offset.value} {data.volume}@{data.price}"
+        )
+        return text
+
+
+class OrderItem(MarkerItem):
+    """"""
+
+    marker_filled: bool = False
+
+    def get_marker_key(self, data: OrderData) -> str:
+        """"""
+        return data.vt_orderid
+
+    def get_marker_text(self, data: OrderData) -> str:
+        """"""
+        dt: datetime = data.datetime
+        text: str = (
+            f"Order {dt.strftime('%H:%M:%S')} {data.status.value} "
+            f"{data.direction.value}{data.offset.value} {data.traded}/{data.volume}@{data.price}"
+        )
+        return text
@@ -1,10 +1,10 @@
 from datetime import datetime
-from typing import List, Dict, Type
+from typing import List, Dict, Type, Union
 
 import pyqtgraph as pg
 
 from vnpy.trader.ui import QtGui, QtWidgets, QtCore
-from vnpy.trader.object import BarData
+from vnpy.trader.object import BarData, OrderData, TradeData
 
 from .manager import BarManager
 from .base import (
@@ -12,7 +12,7 @@ from .base import (
     to_int, NORMAL_FONT
 )
 from .axis import DatetimeAxis
-from .item import ChartItem
+from .item import ChartItem, MarkerItem, TradeItem, OrderItem
 
 
 pg.setConfigOptions(antialias=True)
@@ -29,8 +29,8 @@ class ChartWidget(pg.PlotWidget):
         self._manager: BarManager = BarManager()
 
         self._plots: Dict[str, pg.PlotItem] = {}
-        self._items: Dict[str, ChartItem] = {}
-        self._item_plot_map: Dict[ChartItem, pg.PlotItem] = {}
+        self._items: Dict[str, Union[ChartItem, MarkerItem]] = {}
+        self._item_plot_map: Dict[Union[ChartItem, MarkerItem], pg.PlotItem] = {}
 
         self._first_plot: pg.PlotItem = None
         self._cursor: ChartCursor = None
@@ -114,14 +114,14 @@ class ChartWidget(pg.PlotWidget):
 
     def add_item(
         self,
-        item_class: Type[ChartItem],
+        item_class: Type[Union[ChartItem, MarkerItem]],
         item_name: str,
         plot_name: str
     ) -> None:
         """
         Add chart item.
         """
-        item: ChartItem = item_class(self._manager)
+        item: Union[ChartItem, MarkerItem] = item_class(self._manager)
         self._items[item_name] = item
 
         plot: pg.PlotItem = self._plots.get(plot_name)
@@ -180,6 +180,22 @@ class ChartWidget(pg.PlotWidget):
         if self._right_ix >= (self._manager.get_count() - self._bar_count / 2):
             self.move_to_right()
 
+    def update_trades(self, trades: List[TradeData]) -> None:
+        """
+        Update a list of trade data into trade marker items.
+        """
+        for item in self._items.values():
+            if isinstance(item, TradeItem):
+                item.update_markers(trades)
+
+    def update_orders(self, orders: List[OrderData]) -> None:
+        """
+        Update a list of order data into order marker items.
+        """
+        for item in self._items.values():
+            if isinstance(item, OrderItem):
+                item.update_markers(orders)
+
     def _update_plot_limits(self) -> None:
         """
         Update the limit of plots.
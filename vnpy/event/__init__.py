@@ -1 +1,3 @@
+from .clock import BaseClock, WallClock, VirtualClock, get_clock, set_clock
 from .engine import Event, EventEngine, EVENT_TIMER
+from .journal import EventJournal, JournalReader
@@ -0,0 +1,147 @@
+"""
+Clock providing current time for event engine and trading components.
+"""
+
+from abc import ABC, abstractmethod
+from datetime import datetime
+from threading import Condition
+from time import monotonic, sleep, time
+
+
+class BaseClock(ABC):
+    """
+    Abstract clock class.
+    """
+
+    @abstractmethod
+    def time(self) -> float:
+        """
+        Return current timestamp in seconds.
+        """
+        pass
+
+    def now(self) -> datetime:
+        """
+        Return current local datetime.
+        """
+        return datetime.fromtimestamp(self.time())
+
+    def monotonic(self) -> float:
+        """
+        Return time in seconds which never goes backward, used for
+        deadlines and intervals instead of timestamp.
+        """
+        return self.time()
+
+    @abstractmethod
+    def wait_until(self, deadline: float) -> bool:
+        """
+        Block until monotonic time of clock reaches deadline.
+
+        Return False if woken up by interrupt before that.
+        """
+        pass
+
+    def interrupt(self) -> None:
+        """
+        Wake up all threads blocked in wait_until.
+        """
+        pass
+
+
+class WallClock(BaseClock):
+    """
+    Clock following system time.
+
+    Deadlines are waited on monotonic time, so that stepping system time
+    by NTP or manually does not stall or burst timers.
+    """
+
+    def time(self) -> float:
+        """"""
+        return time()
+
+    def now(self) -> datetime:
+        """"""
+        return datetime.now()
+
+    def monotonic(self) -> float:
+        """"""
+        return monotonic()
+
+    def wait_until(self, deadline: float) -> bool:
+        """"""
+        seconds: float = deadline - monotonic()
+        if seconds > 0:
+            sleep(seconds)
+        return True
+
+
+class VirtualClock(BaseClock):
+    """
+    Clock whose time only moves when advanced manually, for example
+    by the timestamp of events during backtesting or replay.
+    """
+
+    def __init__(self, start: float = 0) -> None:
+        """"""
+        self._time: float = start
+        self._condition: Condition = Condition()
+        self._interrupt_count: int = 0
+
+    def time(self) -> float:
+        """"""
+        return self._time
+
+    def set_time(self, timestamp: float) -> None:
+        """
+        Move clock forward to timestamp, it never goes backward.
+        """
+        with self._condition:
+            if timestamp > self._time:
+                self._time = timestamp
+                self._condition.notify_all()
+
+    def advance(self, seconds: float) -> None:
+        """
+        Move clock forward by seconds.
+        """
+        self.set_time(self._time + seconds)
+
+    def wait_until(self, deadline: float) -> bool:
+        """
+        Virtual time never goes backward, so it is used as monotonic time.
+        """
+        with self._condition:
+            interrupt_count: int = self._interrupt_count
+
+            self._condition.wait_for(
+                lambda: self._time >= deadline or self._interrupt_count != interrupt_count
+            )
+
+            return self._time >= deadline
+
+    def interrupt(self) -> None:
+        """"""
+        with self._condition:
+            self._interrupt_count += 1
+            self._condition.notify_all()
+
+
+# Global clock used by components without clock specified
+CLOCK: BaseClock = WallClock()
+
+
+def get_clock() -> BaseClock:
+    """
+    Get global clock.
+    """
+    return CLOCK
+
+
+def set_clock(clock: BaseClock) -> None:
+    """
+    Replace global clock, should be called before engines created.
+    """
+    global CLOCK
+    CLOCK = clock
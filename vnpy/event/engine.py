@@ -4,9 +4,10 @@ Event-driven framework of VeighNa framework.
 
 from collections import defaultdict
 from queue import Empty, Queue
-from threading import Thread
-from time import sleep
-from typing import Any, Callable, List
+from threading import Lock, Thread
+from typing import Any, Callable, Dict, List
+
+from .clock import BaseClock, get_clock
 
 EVENT_TIMER = "eTimer"
 
@@ -37,18 +38,23 @@ class EventEngine:
     which can be used for timing purpose.
     """
 
-    def __init__(self, interval: int = 1) -> None:
+    def __init__(self, interval: int = 1, clock: BaseClock = None) -> None:
         """
         Timer event is generated every 1 second by default, if
         interval not specified.
+
+        Timer follows global clock if clock not specified.
         """
         self._interval: int = interval
+        self._clock: BaseClock = clock or get_clock()
         self._queue: Queue = Queue()
         self._active: bool = False
         self._thread: Thread = Thread(target=self._run)
         self._timer: Thread = Thread(target=self._run_timer)
         self._handlers: defaultdict = defaultdict(list)
         self._general_handlers: List = []
+        self._batch_types: Dict[str, Callable[[Any], List[str]]] = {}
+        self._lock: Lock = Lock()
 
     def _run(self) -> None:
         """
@@ -72,17 +78,64 @@ class EventEngine:
         if event.type in self._handlers:
             [handler(event) for handler in self._handlers[event.type]]
 
+        if event.type in self._batch_types:
+            self._process_batch(event)
+
         if self._general_handlers:
             [handler(event) for handler in self._general_handlers]
 
+    def _process_batch(self, event: Event) -> None:
+        """
+        Dispatch each record of batch event to handlers of its single
+        event types in place, without putting them into queue.
+
+        Handlers bound to the same object as a handler of the batch event
+        are skipped, as the object processes the whole batch already.
+        """
+        owners: list = [
+            handler.__self__ for handler in self._handlers.get(event.type, [])
+            if hasattr(handler, "__self__")
+        ]
+
+        get_types: Callable[[Any], List[str]] = self._batch_types[event.type]
+        type_handlers: Dict[str, list] = {}
+
+        for data in event.data:
+            for type in get_types(data):
+                handlers: list = type_handlers.get(type, None)
+                if handlers is None:
+                    handlers = [
+                        handler for handler in self._handlers.get(type, [])
+                        if not any(getattr(handler, "__self__", None) is owner for owner in owners)
+                    ]
+                    type_handlers[type] = handlers
+
+                if not handlers:
+                    continue
+
+                single: Event = Event(type, data)
+                [handler(single) for handler in handlers]
+
     def _run_timer(self) -> None:
         """
-        Sleep by interval second(s) and then generate a timer event.
+        Wait by interval second(s) of clock and then generate a timer event.
+
+        Deadlines missed by more than one interval, such as after system
+        suspend, are skipped instead of generating a burst of events.
         """
+        next_time: float = self._clock.monotonic() + self._interval
+
         while self._active:
-            sleep(self._interval)
+            if not self._clock.wait_until(next_time):
+                continue
+
             event: Event = Event(EVENT_TIMER)
             self.put(event)
+            next_time += self._interval
+
+            now: float = self._clock.monotonic()
+            if now - next_time > self._interval:
+                next_time = now + self._interval
 
     def start(self) -> None:
         """
@@ -97,9 +150,16 @@ class EventEngine:
         Stop event engine.
         """
         self._active = False
+        self._clock.interrupt()
         self._timer.join()
         self._thread.join()
 
+    def get_clock(self) -> BaseClock:
+        """
+        Get clock used by event engine.
+        """
+        return self._clock
+
     def put(self, event: Event) -> None:
         """
         Put an event object into event queue.
@@ -110,34 +170,48 @@ class EventEngine:
         """
         Register a new handler function for a specific event type. Every
         function can only be registered once for each event type.
+
+        Thread-safe, so engines can be initialized in parallel.
         """
-        handler_list: list = self._handlers[type]
-        if handler not in handler_list:
-            handler_list.append(handler)
+        with self._lock:
+            handler_list: list = self._handlers[type]
+            if handler not in handler_list:
+                handler_list.append(handler)
 
     def unregister(self, type: str, handler: HandlerType) -> None:
         """
         Unregister an existing handler function from event engine.
         """
-        handler_list: list = self._handlers[type]
+        with self._lock:
+            handler_list: list = self._handlers[type]
+
+            if handler in handler_list:
+                handler_list.remove(handler)
 
-        if handler in handler_list:
-            handler_list.remove(handler)
+            if not handler_list:
+                self._handlers.pop(type)
 
-        if not handler_list:
-            self._handlers.pop(type)
+    def register_batch_type(self, type: str, get_types: Callable[[Any], List[str]]) -> None:
+        """
+        Register batch event type whose data is a list of records, and
+        function returning single event types of each record.
+        """
+        with self._lock:
+            self._batch_types[type] = get_types
 
     def register_general(self, handler: HandlerType) -> None:
         """
         Register a new handler function for all event types. Every
         function can only be registered once for each event type.
         """
-        if handler not in self._general_handlers:
-            self._general_handlers.append(handler)
+        with self._lock:
+            if handler not in self._general_handlers:
+                self._general_handlers.append(handler)
 
     def unregister_general(self, handler: HandlerType) -> None:
         """
         Unregister an existing general handler function.
         """
-        if handler in self._general_handlers:
-            self._general_handlers.remove(handler)
+        with self._lock:
+            if handler in self._general_handlers:
+                self._general_handlers.remove(handler)
@@ -0,0 +1,380 @@
+"""
+Binary journal of events flowing through event engine.
+"""
+
+import mmap
+import pickle
+import struct
+import zlib
+from datetime import datetime, time, timedelta
+from pathlib import Path
+from time import sleep, time_ns
+from typing import Callable, Iterator, Optional, Set, Tuple
+
+from .engine import Event, EventEngine, EVENT_TIMER
+
+
+JOURNAL_MAGIC: bytes = b"VNJOURN2"
+
+# Record header: payload size, payload crc32, enqueue ns, dispatch ns, event type size
+RECORD_HEADER: struct.Struct = struct.Struct("<IIqqh")
+
+
+class EventJournal:
+    """
+    Record events into daily memory-mapped journal files.
+
+    Each record stores the event type and pickled data object, together
+    with nanosecond timestamps of when the event was put into queue and
+    when it was dispatched by event engine. Payload is written before
+    header, and checked with crc32 when read, so a record torn by crash
+    is treated as end of journal.
+
+    Hooks are chained to functions saved on start, and only restored on
+    close if no other hook was added on top of journal. Failure of writing
+    a record is passed to error callback, and never stops dispatching.
+    """
+
+    chunk_size: int = 64 * 1024 * 1024      # File is extended by chunk size
+
+    def __init__(
+        self,
+        event_engine: EventEngine,
+        folder: Path,
+        ignore_types: Set[str] = None,
+        on_error: Callable[[Event, Exception], None] = None
+    ) -> None:
+        """
+        Timer events are not recorded by default.
+        """
+        self.event_engine: EventEngine = event_engine
+        self.folder: Path = folder
+        self.on_error: Optional[Callable[[Event, Exception], None]] = on_error
+
+        if ignore_types is None:
+            ignore_types = {EVENT_TIMER}
+        self.ignore_types: Set[str] = ignore_types
+
+        self.date: str = ""
+        self.rollover_ns: int = 0
+        self.file = None
+        self.buffer: Optional[mmap.mmap] = None
+        self.offset: int = 0
+        self.capacity: int = 0
+
+        self.error_count: int = 0
+        self.failing: bool = False
+
+        self.active: bool = False
+        self.engine_put: Callable = None
+        self.engine_process: Callable = None
+
+    def start(self) -> None:
+        """
+        Hook put and process functions of event engine.
+        """
+        self.active = True
+
+        # Hooks kept in chain after close are reused
+        if self.engine_put:
+            return
+
+        self.engine_put = self.event_engine.put
+        self.engine_process = self.event_engine._process
+
+        self.event_engine.put = self.put
+        self.event_engine._process = self.process
+
+    def close(self) -> None:
+        """
+        Restore event engine and close journal file.
+
+        If other hooks were added on top of journal, functions are not
+        restored to keep their chain intact, and journal only passes
+        events through afterwards.
+        """
+        self.active = False
+
+        if (
+            self.engine_put
+            and self.event_engine.put == self.put
+            and self.event_engine._process == self.process
+        ):
+            self.event_engine.put = self.engine_put
+            self.event_engine._process = self.engine_process
+
+            self.engine_put = None
+            self.engine_process = None
+
+        self.close_file()
+
+    def put(self, event: Event) -> None:
+        """
+        Record enqueue time before putting event into queue.
+        """
+        if self.active:
+            event.enqueue_ns = time_ns()
+        self.engine_put(event)
+
+    def process(self, event: Event) -> None:
+        """
+        Record event when it is dispatched by event engine.
+        """
+        if self.active and event.type not in self.ignore_types:
+            try:
+                self.write(event, getattr(event, "enqueue_ns", 0), time_ns())
+                self.failing = False
+            except Exception as ex:
+                self.handle_error(event, ex)
+
+        self.engine_process(event)
+
+    def handle_error(self, event: Event, ex: Exception) -> None:
+        """
+        Count record failed, only the first failure of consecutive ones
+        is reported, so that reporting by log event does not loop.
+        """
+        self.error_count += 1
+
+        if self.failing:
+            return
+        self.failing = True
+
+        if self.on_error:
+            self.on_error(event, ex)
+
+    def write(self, event: Event, enqueue_ns: int, dispatch_ns: int) -> None:
+        """
+        Write one event record into journal file.
+        """
+        timestamp_ns: int = enqueue_ns or dispatch_ns
+        if timestamp_ns >= self.rollover_ns:
+            self.rollover(timestamp_ns)
+
+        type_data: bytes = event.type.encode("utf8")
+        data: bytes = pickle.dumps(event.data, pickle.HIGHEST_PROTOCOL)
+        size: int = len(type_data) + len(data)
+        crc: int = zlib.crc32(data, zlib.crc32(type_data))
+
+        end: int = self.offset + RECORD_HEADER.size + size
+        if end > self.capacity:
+            self.extend_file(end)
+
+        buffer: mmap.mmap = self.buffer
+        start: int = self.offset + RECORD_HEADER.size
+
+        buffer[start:start + len(type_data)] = type_data
+        buffer[start + len(type_data):end] = data
+
+        # Header with size is written last to commit the record
+        RECORD_HEADER.pack_into(buffer, self.offset, size, crc, enqueue_ns, dispatch_ns, len(type_data))
+        self.offset = end
+
+    def rollover(self, timestamp_ns: int) -> None:
+        """
+        Switch to journal file of date of timestamp, and calculate time
+        of next rollover at midnight.
+        """
+        dt: datetime = datetime.fromtimestamp(timestamp_ns / 1_000_000_000)
+
+        date: str = dt.strftime("%Y%m%d")
+        if date != self.date:
+            self.open_file(date)
+
+        midnight: datetime = datetime.combine(dt.date() + timedelta(days=1), time(0))
+        self.rollover_ns = int(midnight.timestamp() * 1_000_000_000)
+
+    def open_file(self, date: str) -> None:
+        """
+        Open journal file of date, appending to existing records.
+        """
+        self.close_file()
+
+        self.date = date
+        path: Path = self.folder.joinpath(f"journal_{date}.bin")
+
+        if path.exists():
+            self.file = open(path, "r+b")
+            self.offset = find_journal_end(path)
+        else:
+            self.file = open(path, "w+b")
+            self.file.write(JOURNAL_MAGIC)
+            self.offset = len(JOURNAL_MAGIC)
+
+        self.extend_file(self.offset)
+
+    def extend_file(self, size: int) -> None:
+        """
+        Extend journal file to hold at least size bytes and remap it.
+        """
+        if self.buffer:
+            self.buffer.close()
+
+        chunks: int = size // self.chunk_size + 1
+        self.capacity = chunks * self.chunk_size
+
+        self.file.truncate(self.capacity)
+        self.buffer = mmap.mmap(self.file.fileno(), self.capacity)
+
+    def close_file(self) -> None:
+        """
+        Truncate unused space and close journal file.
+        """
+        if not self.file:
+            return
+
+        self.buffer.flush()
+        self.buffer.close()
+        self.buffer = None
+
+        self.file.truncate(self.offset)
+        self.file.close()
+        self.file = None
+
+        self.date = ""
+        self.rollover_ns = 0
+
+
+def check_record(buffer: mmap.mmap, offset: int, size: int) -> Optional[tuple]:
+    """
+    Return header of complete record at offset, or None if there is no
+    record or record is torn.
+    """
+    if offset + RECORD_HEADER.size > size:
+        return None
+
+    header: tuple = RECORD_HEADER.unpack_from(buffer, offset)
+    record_size, crc = header[:2]
+
+    # Zero size means end of records in preallocated space
+    start: int = offset + RECORD_HEADER.size
+    if not record_size or start + record_size > size:
+        return None
+
+    if zlib.crc32(buffer[start:start + record_size]) != crc:
+        return None
+
+    return header
+
+
+def find_journal_end(path: Path) -> int:
+    """
+    Find offset after the last complete record in journal file, records
+    are verified with crc32 without unpickling.
+    """
+    with open(path, "rb") as f:
+        size: int = path.stat().st_size
+        if size <= len(JOURNAL_MAGIC):
+            return len(JOURNAL_MAGIC)
+
+        buffer: mmap.mmap = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        offset: int = len(JOURNAL_MAGIC)
+
+        while True:
+            header: Optional[tuple] = check_record(buffer, offset, size)
+            if not header:
+                break
+            offset += RECORD_HEADER.size + header[0]
+
+        buffer.close()
+        return offset
+
+
+class JournalReader:
+    """
+    Read events recorded in a journal file.
+    """
+
+    def __init__(self, path: Path) -> None:
+        """"""
+        self.path: Path = Path(path)
+
+        self.file = open(self.path, "rb")
+        self.size: int = self.path.stat().st_size
+        self.offset: int = len(JOURNAL_MAGIC)
+
+        if self.size:
+            self.buffer: Optional[mmap.mmap] = mmap.mmap(
+                self.file.fileno(), 0, access=mmap.ACCESS_READ
+            )
+        else:
+            self.buffer = None
+
+        if self.buffer is None or self.buffer[:len(JOURNAL_MAGIC)] != JOURNAL_MAGIC:
+            self.close()
+            raise ValueError(f"Invalid journal file: {self.path}")
+
+    def __enter__(self) -> "JournalReader":
+        """"""
+        return self
+
+    def __exit__(self, *args) -> None:
+        """"""
+        self.close()
+
+    def __iter__(self) -> Iterator[Tuple[int, int, Event]]:
+        """
+        Iterate records as (enqueue ns, dispatch ns, event).
+        """
+        buffer: mmap.mmap = self.buffer
+        header_size: int = RECORD_HEADER.size
+
+        while True:
+            header: Optional[tuple] = check_record(buffer, self.offset, self.size)
+            if not header:
+                break
+
+            size, _crc, enqueue_ns, dispatch_ns, type_size = header
+            end: int = self.offset + header_size + size
+
+            start: int = self.offset + header_size
+            type: str = buffer[start:start + type_size].decode("utf8")
+            data: object = pickle.loads(buffer[start + type_size:end])
+
+            self.offset = end
+            yield enqueue_ns, dispatch_ns, Event(type, data)
+
+    def replay(
+        self,
+        event_engine: EventEngine,
+        speed: float = 0,
+        types: Set[str] = None
+    ) -> int:
+        """
+        Put recorded events into event engine in original order.
+
+        Events are put as fast as possible if speed is 0, otherwise
+        original intervals between events are scaled by speed.
+        Return the number of events replayed.
+        """
+        count: int = 0
+        first_ns: int = 0
+        start_ns: int = time_ns()
+
+        for enqueue_ns, _dispatch_ns, event in self:
+            if types and event.type not in types:
+                continue
+
+            if speed:
+                if not first_ns:
+                    first_ns = enqueue_ns
+
+                target_ns: int = start_ns + int((enqueue_ns - first_ns) / speed)
+                wait_ns: int = target_ns - time_ns()
+                if wait_ns > 0:
+                    sleep(wait_ns / 1e9)
+
+            event_engine.put(event)
+            count += 1
+
+        return count
+
+    def close(self) -> None:
+        """"""
+        if self.buffer:
+            self.buffer.close()
+            self.buffer = None
+
+        if self.file:
+            self.file.close()
+            self.file = None
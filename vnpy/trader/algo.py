@@ -0,0 +1,900 @@
+"""
+Execution algorithms slicing parent orders into child orders.
+"""
+
+from collections import defaultdict
+from datetime import datetime, timedelta
+from heapq import heappop, heappush
+from threading import Condition, Thread
+from typing import Callable, Dict, List, Optional, Set, Tuple, Type
+
+from vnpy.event import Event, EventEngine, EVENT_TIMER, BaseClock, VirtualClock
+
+from .constant import AlgoStatus, Direction, Interval, Offset, OrderType
+from .engine import BaseEngine, MainEngine
+from .event import EVENT_TICK, EVENT_ORDER, EVENT_TRADE, EVENT_ALGO, EVENT_ALGO_TIMER
+from .object import (
+    BarData,
+    CancelRequest,
+    ContractData,
+    OrderData,
+    OrderRequest,
+    SubscribeRequest,
+    TickData,
+    TradeData
+)
+from .utility import extract_vt_symbol, floor_to, round_to
+from .locale import _
+
+
+class AlgoScheduler:
+    """
+    Timer heap firing algo timers with millisecond precision.
+
+    Due time is monotonic time of clock of event engine. With real time
+    clock, timers due are collected in a background thread and passed to
+    callback in one batch, so that algos are still run in event engine
+    thread without waiting for one second timer event. With virtual clock
+    of replay, no thread is started and timers due are only popped by
+    engine when events are processed, so algos follow recorded time.
+    """
+
+    def __init__(self, clock: BaseClock, callback: Callable[[List[Tuple[str, float]]], None]) -> None:
+        """"""
+        self.clock: BaseClock = clock
+        self.callback: Callable = callback
+
+        self.heap: List[Tuple[float, str]] = []
+        self.condition: Condition = Condition()
+
+        self.active: bool = False
+        self.thread: Optional[Thread] = None
+
+    def start(self) -> None:
+        """"""
+        self.active = True
+
+        if not isinstance(self.clock, VirtualClock):
+            self.thread = Thread(target=self.run, daemon=True)
+            self.thread.start()
+
+    def stop(self) -> None:
+        """"""
+        if not self.active:
+            return
+
+        with self.condition:
+            self.active = False
+            self.condition.notify()
+
+        if self.thread:
+            self.thread.join()
+
+    def schedule(self, algo_id: str, due: float) -> None:
+        """
+        Add timer of algo due at monotonic time of clock.
+        """
+        with self.condition:
+            heappush(self.heap, (due, algo_id))
+
+            # Wake up scheduler thread if new timer is the earliest
+            if self.heap[0][0] == due:
+                self.condition.notify()
+
+    def pop_due(self) -> List[Tuple[str, float]]:
+        """
+        Pop all timers due as list of (algo_id, due).
+        """
+        heap: list = self.heap
+        timers: List[Tuple[str, float]] = []
+
+        with self.condition:
+            now: float = self.clock.monotonic()
+            while heap and heap[0][0] <= now:
+                due, algo_id = heappop(heap)
+                timers.append((algo_id, due))
+
+        return timers
+
+    def run(self) -> None:
+        """"""
+        heap: list = self.heap
+
+        while True:
+            with self.condition:
+                while self.active:
+                    if not heap:
+                        self.condition.wait()
+                        continue
+
+                    timeout: float = heap[0][0] - self.clock.monotonic()
+                    if timeout <= 0:
+                        break
+                    self.condition.wait(timeout)
+
+                if not self.active:
+                    return
+
+            timers: List[Tuple[str, float]] = self.pop_due()
+            if timers:
+                self.callback(timers)
+
+
+class AlgoTemplate:
+    """
+    Template for execution algorithm of a parent order.
+
+    All callbacks are run in event engine thread. Child orders should
+    only be sent in on_tick, on_order, on_trade and on_timer, while
+    on_start is used to initialize parameters and schedule timer.
+    """
+
+    algo_name: str = ""
+    default_setting: dict = {}
+
+    def __init__(
+        self,
+        algo_engine: "AlgoEngine",
+        algo_id: str,
+        vt_symbol: str,
+        direction: Direction,
+        offset: Offset,
+        price: float,
+        volume: float,
+        setting: dict
+    ) -> None:
+        """"""
+        self.algo_engine: AlgoEngine = algo_engine
+        self.algo_id: str = algo_id
+
+        self.vt_symbol: str = vt_symbol
+        self.direction: Direction = direction
+        self.offset: Offset = offset
+        self.price: float = price
+        self.volume: float = volume
+
+        self.setting: dict = dict(self.default_setting)
+        self.setting.update(setting)
+
+        self.status: AlgoStatus = AlgoStatus.PAUSED
+        self.traded: float = 0
+        self.traded_price: float = 0
+
+        self.active_orders: Dict[str, OrderData] = {}
+        self.next_time: float = 0
+
+        # Traded volume of child orders from order events and trade events,
+        # kept until both agree as order may be all traded before its trades
+        self.order_traded: Dict[str, float] = {}
+        self.trade_traded: Dict[str, float] = {}
+
+    def update_tick(self, tick: TickData) -> None:
+        """"""
+        if self.status == AlgoStatus.RUNNING:
+            self.on_tick(tick)
+
+    def update_order(self, order: OrderData) -> None:
+        """"""
+        vt_orderid: str = order.vt_orderid
+        self.order_traded[vt_orderid] = max(order.traded, self.order_traded.get(vt_orderid, 0))
+
+        if order.is_active():
+            self.active_orders[vt_orderid] = order
+        else:
+            self.active_orders.pop(vt_orderid, None)
+            self.check_order_settled(vt_orderid)
+
+        if self.status == AlgoStatus.RUNNING:
+            self.on_order(order)
+
+    def update_trade(self, trade: TradeData) -> None:
+        """"""
+        vt_orderid: str = trade.vt_orderid
+        self.trade_traded[vt_orderid] = self.trade_traded.get(vt_orderid, 0) + trade.volume
+        self.check_order_settled(vt_orderid)
+
+        cost: float = self.traded_price * self.traded + trade.price * trade.volume
+        self.traded += trade.volume
+        self.traded_price = cost / self.traded
+
+        if self.status == AlgoStatus.RUNNING:
+            self.on_trade(trade)
+
+        # Late trades after algo stopped or finished only update data
+        if self.traded >= self.volume and self.status in {AlgoStatus.RUNNING, AlgoStatus.PAUSED}:
+            self.finish()
+        else:
+            self.put_event()
+
+    def update_timer(self) -> None:
+        """"""
+        if self.status == AlgoStatus.RUNNING:
+            self.on_timer()
+
+    def check_order_settled(self, vt_orderid: str) -> None:
+        """
+        Remove traded volume records of order finished with all its
+        trades received.
+        """
+        if vt_orderid in self.active_orders or vt_orderid not in self.order_traded:
+            return
+
+        if self.trade_traded.get(vt_orderid, 0) >= self.order_traded[vt_orderid]:
+            self.order_traded.pop(vt_orderid)
+            self.trade_traded.pop(vt_orderid, None)
+
+    def is_order_settled(self, vt_orderid: str) -> bool:
+        """
+        Check if no more order or trade event of order is expected.
+        """
+        return (
+            vt_orderid not in self.active_orders
+            and vt_orderid not in self.order_traded
+            and vt_orderid not in self.trade_traded
+        )
+
+    def start(self) -> None:
+        """"""
+        self.status = AlgoStatus.RUNNING
+        self.on_start()
+        self.put_event()
+
+    def pause(self) -> None:
+        """"""
+        if self.status != AlgoStatus.RUNNING:
+            return
+
+        self.status = AlgoStatus.PAUSED
+        self.cancel_all()
+        self.put_event()
+
+    def resume(self) -> None:
+        """
+        Resume algo and trigger timer immediately.
+        """
+        if self.status != AlgoStatus.PAUSED:
+            return
+
+        self.status = AlgoStatus.RUNNING
+        self.schedule(0)
+        self.put_event()
+
+    def stop(self) -> None:
+        """"""
+        if self.status in {AlgoStatus.STOPPED, AlgoStatus.FINISHED}:
+            return
+
+        self.status = AlgoStatus.STOPPED
+        self.cancel_all()
+        self.on_stop()
+        self.put_event()
+
+    def finish(self) -> None:
+        """"""
+        if self.status in {AlgoStatus.STOPPED, AlgoStatus.FINISHED}:
+            return
+
+        self.status = AlgoStatus.FINISHED
+        self.cancel_all()
+        self.on_stop()
+        self.put_event()
+
+    def on_start(self) -> None:
+        """"""
+        pass
+
+    def on_stop(self) -> None:
+        """"""
+        pass
+
+    def on_tick(self, tick: TickData) -> None:
+        """"""
+        pass
+
+    def on_order(self, order: OrderData) -> None:
+        """"""
+        pass
+
+    def on_trade(self, trade: TradeData) -> None:
+        """"""
+        pass
+
+    def on_timer(self) -> None:
+        """"""
+        pass
+
+    def buy(self, price: float, volume: float, order_type: OrderType = OrderType.LIMIT) -> List[str]:
+        """"""
+        return self.algo_engine.send_order(self, Direction.LONG, price, volume, order_type)
+
+    def sell(self, price: float, volume: float, order_type: OrderType = OrderType.LIMIT) -> List[str]:
+        """"""
+        return self.algo_engine.send_order(self, Direction.SHORT, price, volume, order_type)
+
+    def send_order(self, price: float, volume: float, order_type: OrderType = OrderType.LIMIT) -> List[str]:
+        """
+        Send child order in direction of algo.
+        """
+        return self.algo_engine.send_order(self, self.direction, price, volume, order_type)
+
+    def cancel_order(self, vt_orderid: str) -> None:
+        """"""
+        self.algo_engine.cancel_order(self, vt_orderid)
+
+    def cancel_all(self) -> None:
+        """"""
+        for vt_orderid in list(self.active_orders):
+            self.cancel_order(vt_orderid)
+
+    def schedule(self, delay: float) -> None:
+        """
+        Call on_timer after delay seconds, replacing timer scheduled before.
+        """
+        self.algo_engine.schedule(self, delay)
+
+    def get_tick(self) -> Optional[TickData]:
+        """"""
+        return self.algo_engine.main_engine.get_tick(self.vt_symbol)
+
+    def get_contract(self) -> Optional[ContractData]:
+        """"""
+        return self.algo_engine.main_engine.get_contract(self.vt_symbol)
+
+    def get_active_volume(self) -> float:
+        """
+        Get volume of child orders not traded yet.
+        """
+        return sum(order.volume - order.traded for order in self.active_orders.values())
+
+    def get_traded_volume(self) -> float:
+        """
+        Get traded volume, including volume reported traded by order
+        events whose trades have not arrived yet.
+        """
+        pending: float = 0
+        for vt_orderid, traded in self.order_traded.items():
+            pending += max(traded - self.trade_traded.get(vt_orderid, 0), 0)
+
+        return self.traded + pending
+
+    def get_left_volume(self) -> float:
+        """
+        Get volume not traded nor sent yet.
+        """
+        return self.volume - self.get_traded_volume() - self.get_active_volume()
+
+    def write_log(self, msg: str) -> None:
+        """"""
+        self.algo_engine.main_engine.write_log(f"{self.algo_id}: {msg}", "ALGO")
+
+    def put_event(self) -> None:
+        """"""
+        self.algo_engine.put_algo_event(self)
+
+    def get_data(self) -> dict:
+        """
+        Get status data of algo for monitoring.
+        """
+        return {
+            "algo_id": self.algo_id,
+            "algo_name": self.algo_name,
+            "vt_symbol": self.vt_symbol,
+            "direction": self.direction,
+            "offset": self.offset,
+            "price": self.price,
+            "volume": self.volume,
+            "traded": self.traded,
+            "traded_price": self.traded_price,
+            "status": self.status,
+            "setting": self.setting,
+        }
+
+
+class TargetAlgo(AlgoTemplate):
+    """
+    Base of algos trading towards a target volume changing with time.
+
+    Child order is sent for volume between target and traded, after
+    all active orders are cancelled to avoid trading more than target.
+    Volume traded by order events is counted before trades arrive.
+    """
+
+    def __init__(self, *args, **kwargs) -> None:
+        """"""
+        super().__init__(*args, **kwargs)
+
+        self.target: float = 0
+
+    def update_target(self, target: float) -> None:
+        """"""
+        self.target = min(target, self.volume)
+        self.rebalance()
+
+    def rebalance(self) -> None:
+        """
+        Cancel active orders, and send new order after all cancelled.
+        """
+        if self.active_orders:
+            self.cancel_all()
+            return
+
+        contract: ContractData = self.get_contract()
+        volume: float = floor_to(self.target - self.get_traded_volume(), contract.min_volume)
+        if volume > 0:
+            self.send_order(self.price, volume)
+
+    def on_order(self, order: OrderData) -> None:
+        """"""
+        if not self.active_orders and self.get_traded_volume() < self.target:
+            self.rebalance()
+
+
+class TwapAlgo(TargetAlgo):
+    """
+    Time weighted average price algo, trading same volume each interval.
+    """
+
+    algo_name: str = "TWAP"
+
+    default_setting: dict = {
+        "time": 600,
+        "interval": 60
+    }
+
+    def on_start(self) -> None:
+        """"""
+        self.interval: float = self.setting["interval"]
+        self.slice_count: int = max(round(self.setting["time"] / self.interval), 1)
+        self.slice_index: int = 0
+
+        self.schedule(0)
+
+    def on_timer(self) -> None:
+        """"""
+        if self.slice_index < self.slice_count:
+            self.slice_index += 1
+            self.update_target(self.volume * self.slice_index / self.slice_count)
+        else:
+            self.rebalance()
+
+        self.schedule(self.interval)
+
+
+class VwapAlgo(TargetAlgo):
+    """
+    Volume weighted average price algo, trading volume of each interval
+    in proportion to historical volume curve.
+
+    Volume curve is loaded from minute bars in database of recent days,
+    or can be passed directly with weights of each interval in setting.
+    """
+
+    algo_name: str = "VWAP"
+
+    default_setting: dict = {
+        "time": 600,
+        "interval": 60,
+        "days": 5,
+        "curve": []
+    }
+
+    def on_start(self) -> None:
+        """"""
+        self.interval: float = self.setting["interval"]
+        slice_count: int = max(round(self.setting["time"] / self.interval), 1)
+
+        weights: List[float] = list(self.setting["curve"])
+        if len(weights) != slice_count:
+            weights = self.load_weights(slice_count)
+
+        total: float = sum(weights)
+        if total <= 0:
+            weights = [1] * slice_count
+            total = slice_count
+
+        self.targets: List[float] = []
+        accumulated: float = 0
+        for weight in weights:
+            accumulated += weight
+            self.targets.append(self.volume * accumulated / total)
+
+        self.slice_index: int = 0
+        self.schedule(0)
+
+    def load_weights(self, slice_count: int) -> List[float]:
+        """
+        Sum historical volume curve into weights of each interval.
+        """
+        curve: Dict[int, float] = self.algo_engine.load_volume_curve(self.vt_symbol, self.setting["days"])
+        start: datetime = self.algo_engine.event_engine.get_clock().now()
+
+        weights: List[float] = []
+        for i in range(slice_count):
+            slice_start: datetime = start + timedelta(seconds=i * self.interval)
+            slice_end: datetime = slice_start + timedelta(seconds=self.interval)
+
+            weight: float = 0
+            dt: datetime = slice_start.replace(second=0, microsecond=0)
+            while dt < slice_end:
+                weight += curve.get(dt.hour * 60 + dt.minute, 0)
+                dt += timedelta(minutes=1)
+            weights.append(weight)
+
+        return weights
+
+    def on_timer(self) -> None:
+        """"""
+        if self.slice_index < len(self.targets):
+            self.update_target(self.targets[self.slice_index])
+            self.slice_index += 1
+        else:
+            self.rebalance()
+
+        self.schedule(self.interval)
+
+
+class IcebergAlgo(AlgoTemplate):
+    """
+    Iceberg algo, showing only display volume at limit price each time.
+    """
+
+    algo_name: str = "Iceberg"
+
+    default_setting: dict = {
+        "display_volume": 1,
+        "interval": 0.1
+    }
+
+    def on_start(self) -> None:
+        """"""
+        self.schedule(0)
+
+    def on_timer(self) -> None:
+        """
+        Send next visible order after the last one finished.
+        """
+        if self.active_orders:
+            return
+
+        volume: float = min(self.setting["display_volume"], self.get_left_volume())
+        if volume > 0:
+            self.send_order(self.price, volume)
+
+    def on_order(self, order: OrderData) -> None:
+        """"""
+        if not self.active_orders:
+            self.schedule(self.setting["interval"])
+
+
+class BestLimitAlgo(AlgoTemplate):
+    """
+    Best limit algo, keeping order at best price of own side without
+    exceeding limit price, and following best price when it moves.
+    """
+
+    algo_name: str = "BestLimit"
+
+    default_setting: dict = {
+        "order_volume": 0
+    }
+
+    def on_tick(self, tick: TickData) -> None:
+        """"""
+        if self.direction == Direction.LONG:
+            best_price: float = min(tick.bid_price_1, self.price)
+        else:
+            best_price = max(tick.ask_price_1, self.price)
+
+        if not best_price:
+            return
+
+        if self.active_orders:
+            for order in self.active_orders.values():
+                if order.price != best_price:
+                    self.cancel_all()
+                    break
+            return
+
+        volume: float = self.get_left_volume()
+        if self.setting["order_volume"]:
+            volume = min(volume, self.setting["order_volume"])
+
+        if volume > 0:
+            self.send_order(best_price, volume)
+
+
+class SniperAlgo(AlgoTemplate):
+    """
+    Sniper algo, taking opposite best price once it reaches limit price.
+    """
+
+    algo_name: str = "Sniper"
+
+    def on_tick(self, tick: TickData) -> None:
+        """"""
+        if self.active_orders:
+            self.cancel_all()
+            return
+
+        if self.direction == Direction.LONG:
+            price: float = tick.ask_price_1
+            if not price or price > self.price:
+                return
+            volume: float = tick.ask_volume_1
+        else:
+            price = tick.bid_price_1
+            if not price or price < self.price:
+                return
+            volume = tick.bid_volume_1
+
+        volume = min(volume, self.get_left_volume())
+        if volume > 0:
+            self.send_order(price, volume)
+
+
+class AlgoEngine(BaseEngine):
+    """
+    Runs execution algorithms of parent orders.
+
+    Ticks, orders and trades are routed to algos by vt_symbol and
+    vt_orderid with dict lookup, and algo timers are scheduled with
+    millisecond precision, so thousands of algos can run concurrently.
+    Orders are unlinked from algo after finished with all trades received.
+    """
+
+    def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
+        """"""
+        super().__init__(main_engine, event_engine, "algo")
+
+        self.algo_classes: Dict[str, Type[AlgoTemplate]] = {}
+        self.algos: Dict[str, AlgoTemplate] = {}
+        self.algo_count: int = 0
+
+        self.symbol_algos: Dict[str, Set[AlgoTemplate]] = defaultdict(set)
+        self.order_algos: Dict[str, AlgoTemplate] = {}
+
+        self.scheduler: AlgoScheduler = AlgoScheduler(event_engine.get_clock(), self.put_timer_event)
+
+        for algo_class in [TwapAlgo, VwapAlgo, IcebergAlgo, BestLimitAlgo, SniperAlgo]:
+            self.add_algo_class(algo_class)
+
+        self.register_event()
+        self.scheduler.start()
+
+    def add_algo_class(self, algo_class: Type[AlgoTemplate]) -> None:
+        """"""
+        self.algo_classes[algo_class.algo_name] = algo_class
+
+    def register_event(self) -> None:
+        """"""
+        self.event_engine.register(EVENT_TICK, self.process_tick_event)
+        self.event_engine.register(EVENT_ORDER, self.process_order_event)
+        self.event_engine.register(EVENT_TRADE, self.process_trade_event)
+        self.event_engine.register(EVENT_TIMER, self.process_timer_event)
+        self.event_engine.register(EVENT_ALGO_TIMER, self.process_algo_timer_event)
+
+    def process_tick_event(self, event: Event) -> None:
+        """"""
+        tick: TickData = event.data
+
+        self.check_timers()
+
+        algos: Optional[Set[AlgoTemplate]] = self.symbol_algos.get(tick.vt_symbol, None)
+        if algos:
+            for algo in list(algos):
+                algo.update_tick(tick)
+
+    def process_order_event(self, event: Event) -> None:
+        """"""
+        order: OrderData = event.data
+
+        algo: Optional[AlgoTemplate] = self.order_algos.get(order.vt_orderid, None)
+        if algo:
+            algo.update_order(order)
+
+            if algo.is_order_settled(order.vt_orderid):
+                self.order_algos.pop(order.vt_orderid)
+
+    def process_trade_event(self, event: Event) -> None:
+        """"""
+        trade: TradeData = event.data
+
+        algo: Optional[AlgoTemplate] = self.order_algos.get(trade.vt_orderid, None)
+        if algo:
+            algo.update_trade(trade)
+
+            if algo.is_order_settled(trade.vt_orderid):
+                self.order_algos.pop(trade.vt_orderid)
+
+    def process_timer_event(self, event: Event) -> None:
+        """"""
+        self.check_timers()
+
+    def process_algo_timer_event(self, event: Event) -> None:
+        """"""
+        self.run_timers(event.data)
+
+    def check_timers(self) -> None:
+        """
+        Run timers due by clock, which is required when scheduler runs
+        without thread on virtual clock of replay.
+        """
+        timers: List[Tuple[str, float]] = self.scheduler.pop_due()
+        if timers:
+            self.run_timers(timers)
+
+    def run_timers(self, timers: List[Tuple[str, float]]) -> None:
+        """
+        Run timers due, skipping those replaced by later schedule.
+        """
+        for algo_id, due in timers:
+            algo: Optional[AlgoTemplate] = self.algos.get(algo_id, None)
+
+            if algo and algo.next_time == due:
+                algo.next_time = 0
+                algo.update_timer()
+
+    def put_timer_event(self, timers: List[Tuple[str, float]]) -> None:
+        """"""
+        self.event_engine.put(Event(EVENT_ALGO_TIMER, timers))
+
+    def start_algo(
+        self,
+        algo_name: str,
+        vt_symbol: str,
+        direction: Direction,
+        offset: Offset,
+        price: float,
+        volume: float,
+        setting: dict = None
+    ) -> str:
+        """
+        Start a new algo and return its algo_id.
+        """
+        contract: Optional[ContractData] = self.main_engine.get_contract(vt_symbol)
+        if not contract:
+            self.main_engine.write_log(_("算法启动失败，找不到合约：{}").format(vt_symbol), "ALGO")
+            return ""
+
+        algo_class: Type[AlgoTemplate] = self.algo_classes[algo_name]
+
+        self.algo_count += 1
+        algo_id: str = f"{algo_name}_{self.algo_count}"
+
+        algo: AlgoTemplate = algo_class(
+            self,
+            algo_id,
+            vt_symbol,
+            direction,
+            offset,
+            round_to(price, contract.pricetick),
+            volume,
+            setting or {}
+        )
+        self.algos[algo_id] = algo
+        self.symbol_algos[vt_symbol].add(algo)
+
+        req: SubscribeRequest = SubscribeRequest(contract.symbol, contract.exchange)
+        self.main_engine.subscribe(req, contract.gateway_name)
+
+        algo.start()
+        return algo_id
+
+    def pause_algo(self, algo_id: str) -> None:
+        """"""
+        algo: Optional[AlgoTemplate] = self.algos.get(algo_id, None)
+        if algo:
+            algo.pause()
+
+    def resume_algo(self, algo_id: str) -> None:
+        """"""
+        algo: Optional[AlgoTemplate] = self.algos.get(algo_id, None)
+        if algo:
+            algo.resume()
+
+    def stop_algo(self, algo_id: str) -> None:
+        """"""
+        algo: Optional[AlgoTemplate] = self.algos.get(algo_id, None)
+        if algo:
+            algo.stop()
+
+    def stop_all(self) -> None:
+        """"""
+        for algo_id in list(self.algos):
+            self.stop_algo(algo_id)
+
+    def send_order(
+        self,
+        algo: AlgoTemplate,
+        direction: Direction,
+        price: float,
+        volume: float,
+        order_type: OrderType
+    ) -> List[str]:
+        """
+        Send child order of algo through offset converter.
+        """
+        contract: ContractData = self.main_engine.get_contract(algo.vt_symbol)
+        symbol, exchange = extract_vt_symbol(algo.vt_symbol)
+
+        req: OrderRequest = OrderRequest(
+            symbol=symbol,
+            exchange=exchange,
+            direction=direction,
+            type=order_type,
+            volume=volume,
+            price=round_to(price, contract.pricetick),
+            offset=algo.offset,
+            reference=algo.algo_id
+        )
+
+        gateway_name: str = contract.gateway_name
+        reqs: List[OrderRequest] = self.main_engine.convert_order_request(req, gateway_name, False)
+
+        vt_orderids: List[str] = []
+        for req in reqs:
+            vt_orderid: str = self.main_engine.send_order(req, gateway_name)
+            if not vt_orderid:
+                continue
+
+            vt_orderids.append(vt_orderid)
+            self.order_algos[vt_orderid] = algo
+            self.main_engine.update_order_request(req, vt_orderid, gateway_name)
+
+            # Track order as active before first order event arrives
+            algo.active_orders[vt_orderid] = req.create_order_data(
+                vt_orderid.split(".", 1)[1], gateway_name
+            )
+
+        return vt_orderids
+
+    def cancel_order(self, algo: AlgoTemplate, vt_orderid: str) -> None:
+        """"""
+        order: Optional[OrderData] = self.main_engine.get_order(vt_orderid)
+        if not order:
+            order = algo.active_orders.get(vt_orderid, None)
+            if not order:
+                return
+
+        req: CancelRequest = order.create_cancel_request()
+        self.main_engine.cancel_order(req, order.gateway_name)
+
+    def schedule(self, algo: AlgoTemplate, delay: float) -> None:
+        """"""
+        due: float = self.event_engine.get_clock().monotonic() + delay
+        algo.next_time = due
+        self.scheduler.schedule(algo.algo_id, due)
+
+    def put_algo_event(self, algo: AlgoTemplate) -> None:
+        """"""
+        if algo.status in {AlgoStatus.STOPPED, AlgoStatus.FINISHED}:
+            self.symbol_algos[algo.vt_symbol].discard(algo)
+
+        event: Event = Event(EVENT_ALGO, algo.get_data())
+        self.event_engine.put(event)
+
+    def load_volume_curve(self, vt_symbol: str, days: int) -> Dict[int, float]:
+        """
+        Load average volume of each minute in day from database.
+        """
+        from .database import get_database
+
+        symbol, exchange = extract_vt_symbol(vt_symbol)
+        end: datetime = self.event_engine.get_clock().now()
+        start: datetime = end - timedelta(days=days)
+
+        try:
+            bars: List[BarData] = get_database().load_bar_data(symbol, exchange, Interval.MINUTE, start, end)
+        except Exception as ex:
+            self.main_engine.write_log(_("成交量曲线加载失败：{}").format(ex), "ALGO")
+            return {}
+
+        curve: Dict[int, float] = defaultdict(float)
+        for bar in bars:
+            curve[bar.datetime.hour * 60 + bar.datetime.minute] += bar.volume / days
+
+        return curve
+
+    def close(self) -> None:
+        """"""
+        self.scheduler.stop()
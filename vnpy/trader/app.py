@@ -1,6 +1,6 @@
 from abc import ABC
 from pathlib import Path
-from typing import Type, TYPE_CHECKING
+from typing import List, Type, TYPE_CHECKING
 
 
 if TYPE_CHECKING:
@@ -19,3 +19,4 @@ class BaseApp(ABC):
     engine_class: Type["BaseEngine"] = None     # App engine class
     widget_name: str = ""                       # Class name of app widget
     icon_name: str = ""                         # Icon file name of app widget
+    depends: List[str] = []                     # Names of apps to be initialized before
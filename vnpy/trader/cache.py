@@ -0,0 +1,84 @@
+"""
+Persistent cache of contract data for warm start.
+"""
+
+import mmap
+import os
+import pickle
+from datetime import datetime
+from pathlib import Path
+from typing import Dict, List
+
+from .object import ContractData
+from .utility import get_folder_path
+
+
+class ContractCache:
+    """
+    Contracts of a gateway cached in file by trading day.
+
+    Cached contracts are loaded in bulk at startup, and only contracts
+    new or changed compared with cache need to be pushed by gateway.
+    """
+
+    def __init__(self, gateway_name: str, trading_day: str = "") -> None:
+        """
+        Current date is used if trading day not specified.
+        """
+        self.gateway_name: str = gateway_name
+
+        if not trading_day:
+            trading_day = datetime.now().strftime("%Y%m%d")
+        self.trading_day: str = trading_day
+
+        self.folder: Path = get_folder_path("cache")
+        self.file_path: Path = self.folder.joinpath(f"contract_{gateway_name}_{trading_day}.pkl")
+
+        self.contracts: Dict[str, ContractData] = {}
+        self.changed: bool = False
+
+    def load(self) -> List[ContractData]:
+        """
+        Load contracts from cache file of the trading day.
+        """
+        if not self.file_path.exists() or not self.file_path.stat().st_size:
+            return []
+
+        try:
+            with open(self.file_path, "rb") as f:
+                with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as buffer:
+                    self.contracts = pickle.loads(buffer)
+        except Exception:
+            self.contracts = {}
+
+        return list(self.contracts.values())
+
+    def update_contract(self, contract: ContractData) -> bool:
+        """
+        Update contract into cache, return False if same as cached.
+        """
+        if self.contracts.get(contract.vt_symbol, None) == contract:
+            return False
+
+        self.contracts[contract.vt_symbol] = contract
+        self.changed = True
+        return True
+
+    def save(self) -> None:
+        """
+        Save contracts into cache file and remove files of other days.
+        """
+        if not self.changed:
+            return
+
+        temp_path: Path = self.file_path.with_suffix(".tmp")
+        with open(temp_path, "wb") as f:
+            pickle.dump(self.contracts, f, pickle.HIGHEST_PROTOCOL)
+        os.replace(temp_path, self.file_path)
+
+        self.changed = False
+
+        prefix: str = f"contract_{self.gateway_name}_"
+        for path in self.folder.glob(f"{prefix}*.pkl"):
+            if path != self.file_path and path.stem[len(prefix):].isdigit():
+                path.unlink()
@@ -0,0 +1,228 @@
+"""
+Index of option contracts grouped into chains by portfolio and expiry.
+"""
+
+from bisect import bisect_left, insort
+from datetime import date
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+
+from .constant import OptionType
+from .object import ContractData, TickData
+
+
+TICK_FIELDS: List[str] = [
+    "last_price",
+    "bid_price_1",
+    "ask_price_1",
+    "bid_volume_1",
+    "ask_volume_1",
+    "volume",
+    "open_interest",
+]
+
+
+class OptionChain:
+    """
+    Options of one portfolio with same expiry.
+
+    Call and put of the same option index are paired, and option indexes
+    are kept in a ladder sorted by strike price. Each option is assigned
+    a slot in contiguous arrays of tick fields, which are updated in
+    place on tick so that the whole chain can be analyzed with numpy.
+    """
+
+    def __init__(self, portfolio: str, expiry: Optional[date]) -> None:
+        """"""
+        self.portfolio: str = portfolio
+        self.expiry: Optional[date] = expiry
+
+        self.calls: Dict[str, ContractData] = {}
+        self.puts: Dict[str, ContractData] = {}
+        self.ladder: List[Tuple[float, str]] = []
+
+        self.slots: Dict[str, int] = {}
+        self.vt_symbols: List[str] = []
+        self.size: int = 0
+        self.capacity: int = 0
+
+        self.strike_data: np.ndarray = np.empty(0)
+        self.cp_data: np.ndarray = np.empty(0)
+        self.tick_data: Dict[str, np.ndarray] = {field: np.empty(0) for field in TICK_FIELDS}
+
+    def __len__(self) -> int:
+        """"""
+        return self.size
+
+    def add_contract(self, contract: ContractData) -> None:
+        """
+        Add option contract into chain, or update existing one.
+        """
+        index: str = get_option_index(contract)
+
+        if contract.option_type == OptionType.CALL:
+            options: Dict[str, ContractData] = self.calls
+            pair: Dict[str, ContractData] = self.puts
+        else:
+            options = self.puts
+            pair = self.calls
+
+        if index not in options and index not in pair:
+            insort(self.ladder, (contract.option_strike, index))
+        options[index] = contract
+
+        if contract.vt_symbol in self.slots:
+            return
+
+        if self.size == self.capacity:
+            self.expand(max(self.capacity * 2, 16))
+
+        slot: int = self.size
+        self.size += 1
+
+        self.slots[contract.vt_symbol] = slot
+        self.vt_symbols.append(contract.vt_symbol)
+        self.strike_data[slot] = contract.option_strike
+        self.cp_data[slot] = 1 if contract.option_type == OptionType.CALL else -1
+
+    def expand(self, capacity: int) -> None:
+        """
+        Grow arrays to new capacity, with empty slots filled by nan.
+        """
+        def grow(data: np.ndarray) -> np.ndarray:
+            new_data: np.ndarray = np.full(capacity, np.nan)
+            new_data[:self.size] = data[:self.size]
+            return new_data
+
+        self.strike_data = grow(self.strike_data)
+        self.cp_data = grow(self.cp_data)
+        self.tick_data = {field: grow(data) for field, data in self.tick_data.items()}
+        self.capacity = capacity
+
+    def update_tick(self, tick: TickData) -> None:
+        """
+        Write fields of tick into its slot.
+        """
+        slot: int = self.slots[tick.vt_symbol]
+
+        for field, data in self.tick_data.items():
+            data[slot] = getattr(tick, field)
+
+    def get_pair(self, index: str) -> Tuple[Optional[ContractData], Optional[ContractData]]:
+        """
+        Get call and put with option index.
+        """
+        return self.calls.get(index, None), self.puts.get(index, None)
+
+    def get_pair_by_strike(self, strike: float) -> Tuple[Optional[ContractData], Optional[ContractData]]:
+        """
+        Get call and put with strike price, first option index is used
+        if there are adjusted options with same strike.
+        """
+        ix: int = bisect_left(self.ladder, (strike,))
+        if ix == len(self.ladder) or self.ladder[ix][0] != strike:
+            return None, None
+
+        return self.get_pair(self.ladder[ix][1])
+
+    def get_strikes(self) -> List[float]:
+        """
+        Get sorted strike prices of the chain.
+        """
+        return [strike for strike, _index in self.ladder]
+
+    def get_indexes(self) -> List[str]:
+        """
+        Get option indexes sorted by strike price.
+        """
+        return [index for _strike, index in self.ladder]
+
+    def get_slot(self, vt_symbol: str) -> Optional[int]:
+        """"""
+        return self.slots.get(vt_symbol, None)
+
+    def get_strike_array(self) -> np.ndarray:
+        """
+        Get strike prices of all slots.
+        """
+        return self.strike_data[:self.size]
+
+    def get_cp_array(self) -> np.ndarray:
+        """
+        Get option types of all slots, 1 for call and -1 for put.
+        """
+        return self.cp_data[:self.size]
+
+    def get_tick_array(self, field: str) -> np.ndarray:
+        """
+        Get view of tick field of all slots, nan if no tick received.
+        """
+        return self.tick_data[field][:self.size]
+
+
+class ChainIndex:
+    """
+    Option chains of all portfolios, built incrementally from contracts.
+    """
+
+    def __init__(self) -> None:
+        """"""
+        self.chains: Dict[str, Dict[Optional[date], OptionChain]] = {}
+        self.symbol_chains: Dict[str, OptionChain] = {}
+
+    def add_contract(self, contract: ContractData) -> None:
+        """
+        Add contract into chain of its portfolio and expiry, contracts
+        without option portfolio are ignored.
+        """
+        if not contract.option_portfolio:
+            return
+
+        expiry: Optional[date] = contract.option_expiry.date() if contract.option_expiry else None
+
+        portfolio_chains: Dict[Optional[date], OptionChain] = self.chains.setdefault(contract.option_portfolio, {})
+        chain: Optional[OptionChain] = portfolio_chains.get(expiry, None)
+        if not chain:
+            chain = OptionChain(contract.option_portfolio, expiry)
+            portfolio_chains[expiry] = chain
+
+        chain.add_contract(contract)
+        self.symbol_chains[contract.vt_symbol] = chain
+
+    def update_tick(self, tick: TickData) -> None:
+        """
+        Update tick into option chain, if tick is of option contract.
+        """
+        chain: Optional[OptionChain] = self.symbol_chains.get(tick.vt_symbol, None)
+        if chain:
+            chain.update_tick(tick)
+
+    def get_portfolios(self) -> List[str]:
+        """"""
+        return list(self.chains.keys())
+
+    def get_chain(self, portfolio: str, expiry: Optional[date]) -> Optional[OptionChain]:
+        """"""
+        return self.chains.get(portfolio, {}).get(expiry, None)
+
+    def get_chains(self, portfolio: str) -> List[OptionChain]:
+        """
+        Get chains of portfolio sorted by expiry.
+        """
+        portfolio_chains: Dict[Optional[date], OptionChain] = self.chains.get(portfolio, {})
+        return sorted(portfolio_chains.values(), key=lambda chain: chain.expiry or date.max)
+
+    def get_symbol_chain(self, vt_symbol: str) -> Optional[OptionChain]:
+        """"""
+        return self.symbol_chains.get(vt_symbol, None)
+
+
+def get_option_index(contract: ContractData) -> str:
+    """
+    Get option index used for pairing call and put, strike price is used
+    if gateway does not provide it.
+    """
+    if contract.option_index:
+        return contract.option_index
+    return str(contract.option_strike)
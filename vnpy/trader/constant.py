@@ -39,6 +39,25 @@ class Status(Enum):
     REJECTED = _("拒单")
 
 
+class StopOrderStatus(Enum):
+    """
+    Local stop order status.
+    """
+    WAITING = _("等待中")
+    CANCELLED = _("已撤销")
+    TRIGGERED = _("已触发")
+
+
+class AlgoStatus(Enum):
+    """
+    Execution algorithm status.
+    """
+    RUNNING = _("运行")
+    PAUSED = _("暂停")
+    STOPPED = _("停止")
+    FINISHED = _("结束")
+
+
 class Product(Enum):
     """
     Product class.
@@ -0,0 +1,264 @@
+"""
+Streaming covariance and correlation estimators of portfolio returns.
+"""
+
+from abc import ABC, abstractmethod
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+
+from .object import BarData
+
+
+class CovarianceTemplate(ABC):
+    """
+    Covariance of returns of a fixed list of symbols updated with one
+    return vector each bar, so the cost of each update is O(N^2) instead
+    of rebuilding from history.
+    """
+
+    def __init__(self, vt_symbols: List[str]) -> None:
+        """"""
+        self.vt_symbols: List[str] = vt_symbols
+        self.indexes: Dict[str, int] = {vt_symbol: i for i, vt_symbol in enumerate(vt_symbols)}
+        self.size: int = len(vt_symbols)
+        self.count: int = 0
+
+        self.last_prices: np.ndarray = np.full(self.size, np.nan)
+
+    @abstractmethod
+    def update(self, returns: np.ndarray) -> None:
+        """
+        Update with returns of all symbols in one bar.
+        """
+        pass
+
+    def update_batch(self, returns: np.ndarray) -> None:
+        """
+        Update with returns of multiple bars, one row for each bar.
+        """
+        for row in returns:
+            self.update(row)
+
+    def update_bars(self, bars: Dict[str, BarData]) -> None:
+        """
+        Update with bars of the same time, log return is calculated from
+        close price of previous bar. Return of symbol without new bar is
+        taken as zero.
+        """
+        prices: np.ndarray = self.last_prices.copy()
+        for vt_symbol, bar in bars.items():
+            ix: Optional[int] = self.indexes.get(vt_symbol, None)
+            if ix is not None:
+                prices[ix] = bar.close_price
+
+        last_prices: np.ndarray = self.last_prices
+        self.last_prices = prices
+
+        if np.isnan(last_prices).all():
+            return
+
+        with np.errstate(divide="ignore", invalid="ignore"):
+            returns: np.ndarray = np.log(prices / last_prices)
+        self.update(np.nan_to_num(returns, nan=0.0, posinf=0.0, neginf=0.0))
+
+    @abstractmethod
+    def get_covariance(self) -> np.ndarray:
+        """"""
+        pass
+
+    @abstractmethod
+    def get_dispersion(self) -> float:
+        """
+        Get estimated squared error of covariance, as sum over all
+        elements, used for Ledoit-Wolf shrinkage intensity.
+        """
+        pass
+
+    def get_volatility(self) -> np.ndarray:
+        """"""
+        return np.sqrt(np.maximum(np.diag(self.get_covariance()), 0))
+
+    def get_correlation(self) -> np.ndarray:
+        """
+        Get correlation matrix, zero for symbols without variance.
+        """
+        cov: np.ndarray = self.get_covariance()
+        std: np.ndarray = np.sqrt(np.maximum(np.diag(cov), 0))
+
+        with np.errstate(divide="ignore", invalid="ignore"):
+            corr: np.ndarray = cov / np.outer(std, std)
+
+        corr = np.nan_to_num(corr, nan=0.0, posinf=0.0, neginf=0.0)
+        np.fill_diagonal(corr, np.where(std > 0, 1.0, 0.0))
+        return corr
+
+    def get_shrinkage(self, intensity: Optional[float] = None) -> Tuple[np.ndarray, float]:
+        """
+        Get covariance shrunk towards scaled identity matrix, and the
+        shrinkage intensity used. Optimal intensity of Ledoit-Wolf is
+        estimated if not given.
+        """
+        cov: np.ndarray = self.get_covariance()
+        mu: float = np.trace(cov) / self.size
+        target: np.ndarray = np.eye(self.size) * mu
+
+        if intensity is None:
+            d2: float = float(np.sum((cov - target) ** 2))
+            if d2 > 0:
+                intensity = min(self.get_dispersion(), d2) / d2
+            else:
+                intensity = 1.0
+
+        shrunk: np.ndarray = intensity * target + (1 - intensity) * cov
+        return shrunk, intensity
+
+
+class EwmCovariance(CovarianceTemplate):
+    """
+    Exponentially weighted covariance, with weight of each bar decayed
+    by half after halflife bars.
+    """
+
+    def __init__(self, vt_symbols: List[str], halflife: float) -> None:
+        """"""
+        super().__init__(vt_symbols)
+
+        self.alpha: float = 1 - np.exp(np.log(0.5) / halflife)
+
+        self.mean: np.ndarray = np.zeros(self.size)
+        self.cov: np.ndarray = np.zeros((self.size, self.size))
+        self.dispersion: np.ndarray = np.zeros((self.size, self.size))
+
+    def update(self, returns: np.ndarray) -> None:
+        """"""
+        self.count += 1
+
+        if self.count == 1:
+            self.mean[:] = returns
+            return
+
+        alpha: float = self.alpha
+
+        diff: np.ndarray = returns - self.mean
+        self.mean += alpha * diff
+
+        product: np.ndarray = np.outer(diff, diff)
+        self.cov += alpha * product
+        self.cov *= 1 - alpha
+
+        # Weighted variance of each element of outer product for shrinkage
+        error: np.ndarray = product - self.cov
+        self.dispersion *= 1 - alpha
+        self.dispersion += alpha * error * error
+
+    def get_covariance(self) -> np.ndarray:
+        """"""
+        return self.cov.copy()
+
+    def get_dispersion(self) -> float:
+        """"""
+        effective_count: float = min(self.count, (2 - self.alpha) / self.alpha)
+        return float(self.dispersion.sum()) / effective_count
+
+
+class RollingCovariance(CovarianceTemplate):
+    """
+    Sample covariance of returns in rolling window of bars.
+
+    Sums and cross products are updated by adding new row and removing
+    the oldest row, and rebuilt from window once every window updates
+    to stop accumulation of rounding error.
+    """
+
+    def __init__(self, vt_symbols: List[str], window: int) -> None:
+        """"""
+        super().__init__(vt_symbols)
+
+        self.window: int = window
+        self.buffer: np.ndarray = np.zeros((window, self.size))
+        self.pos: int = 0
+        self.update_count: int = 0
+
+        self.sums: np.ndarray = np.zeros(self.size)
+        self.products: np.ndarray = np.zeros((self.size, self.size))
+
+    def update(self, returns: np.ndarray) -> None:
+        """"""
+        if self.count == self.window:
+            old: np.ndarray = self.buffer[self.pos]
+            self.sums -= old
+            self.products -= np.outer(old, old)
+        else:
+            self.count += 1
+
+        self.buffer[self.pos] = returns
+        self.sums += returns
+        self.products += np.outer(returns, returns)
+
+        self.pos = (self.pos + 1) % self.window
+        self.check_rebuild(1)
+
+    def update_batch(self, returns: np.ndarray) -> None:
+        """
+        Update multiple rows with matrix products, which are run on all
+        cores by BLAS.
+        """
+        returns = np.asarray(returns, dtype=float)[-self.window:]
+        rows: int = len(returns)
+
+        slots: np.ndarray = (self.pos + np.arange(rows)) % self.window
+        old: np.ndarray = self.buffer[slots[slots < self.count]]
+
+        self.sums += returns.sum(axis=0) - old.sum(axis=0)
+        self.products += returns.T @ returns - old.T @ old
+
+        self.buffer[slots] = returns
+        self.pos = (self.pos + rows) % self.window
+        self.count = min(self.count + rows, self.window)
+        self.check_rebuild(rows)
+
+    def check_rebuild(self, rows: int) -> None:
+        """"""
+        self.update_count += rows
+        if self.update_count < self.window:
+            return
+        self.update_count = 0
+
+        data: np.ndarray = self.get_data()
+        self.sums = data.sum(axis=0)
+        self.products = data.T @ data
+
+    def get_data(self) -> np.ndarray:
+        """
+        Get rows in window, not sorted by time.
+        """
+        return self.buffer[:self.count]
+
+    def get_covariance(self) -> np.ndarray:
+        """"""
+        if self.count < 2:
+            return np.zeros((self.size, self.size))
+
+        n: int = self.count
+        return (self.products - np.outer(self.sums, self.sums) / n) / (n - 1)
+
+    def get_dispersion(self) -> float:
+        """
+        Sum of squared distance between outer product of each row and
+        covariance, calculated from window on demand.
+        """
+        n: int = self.count
+        if n < 2:
+            return 0.0
+
+        data: np.ndarray = self.get_data()
+        demeaned: np.ndarray = data - self.sums / n
+        cov: np.ndarray = demeaned.T @ demeaned / n
+
+        # Expand ||y y' - S||^2 to avoid building N x N matrix of each row
+        norms: np.ndarray = np.einsum("ij,ij->i", demeaned, demeaned)
+        quadratic: np.ndarray = np.einsum("ij,jk,ik->i", demeaned, cov, demeaned)
+        total: float = float(np.sum(norms ** 2) - 2 * np.sum(quadratic) + n * np.sum(cov * cov))
+
+        return total / (n * n)
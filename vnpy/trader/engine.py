@@ -1,16 +1,21 @@
 import logging
 from logging import Logger
-import smtplib
 import os
+import sys
 from abc import ABC
 from pathlib import Path
-from datetime import datetime
+from datetime import datetime, date
+from copy import copy
 from email.message import EmailMessage
 from queue import Empty, Queue
-from threading import Thread
-from typing import Any, Type, Dict, List, Optional
+from threading import Thread, Event as TEvent, RLock, current_thread
+from concurrent.futures import ThreadPoolExecutor
+from time import perf_counter, monotonic
+from collections import deque
+from typing import Any, Type, Dict, List, Optional, TextIO, Tuple
 
 from vnpy.event import Event, EventEngine
+from vnpy.event.journal import EventJournal
 from .app import BaseApp
 from .event import (
     EVENT_TICK,
@@ -20,7 +25,10 @@ from .event import (
     EVENT_ACCOUNT,
     EVENT_CONTRACT,
     EVENT_LOG,
-    EVENT_QUOTE
+    EVENT_QUOTE,
+    EVENT_CONTRACTS,
+    EVENT_POSITIONS,
+    EVENT_STOP_ORDER
 )
 from .gateway import BaseGateway
 from .object import (
@@ -38,14 +46,30 @@ from .object import (
     PositionData,
     AccountData,
     ContractData,
+    StopOrderData,
     Exchange
 )
+from .constant import Direction, OrderType, StopOrderStatus
 from .setting import SETTINGS
-from .utility import get_folder_path, TRADER_DIR
+from .utility import get_folder_path, round_to, TRADER_DIR
 from .converter import OffsetConverter
+from .stop import StopOrderBook
+from .chain import ChainIndex, OptionChain
+from .tracer import LatencyTracer
+from .profiler import SamplingProfiler
 from .locale import _
 
 
+def get_contract_event_types(contract: ContractData) -> List[str]:
+    """"""
+    return [EVENT_CONTRACT]
+
+
+def get_position_event_types(position: PositionData) -> List[str]:
+    """"""
+    return [EVENT_POSITION, EVENT_POSITION + position.vt_symbol]
+
+
 class MainEngine:
     """
     Acts as the core of the trading platform.
@@ -53,17 +77,31 @@ class MainEngine:
 
     def __init__(self, event_engine: EventEngine = None) -> None:
         """"""
+        # Startup timeline of (name, start, cost, thread name)
+        self.start_time: float = perf_counter()
+        self.timeline: List[Tuple[str, float, float, str]] = []
+
+        start: float = perf_counter()
         if event_engine:
             self.event_engine: EventEngine = event_engine
         else:
             self.event_engine = EventEngine()
         self.event_engine.start()
+        self.record_timeline("EventEngine", start)
+
+        # Records of batch events are also passed to single event handlers
+        self.event_engine.register_batch_type(EVENT_CONTRACTS, get_contract_event_types)
+        self.event_engine.register_batch_type(EVENT_POSITIONS, get_position_event_types)
 
         self.gateways: Dict[str, BaseGateway] = {}
         self.engines: Dict[str, BaseEngine] = {}
         self.apps: Dict[str, BaseApp] = {}
         self.exchanges: List[Exchange] = []
 
+        # Apps added lazily and not initialized yet
+        self.pending_apps: Dict[str, BaseApp] = {}
+        self.app_locks: Dict[str, RLock] = {}
+
         os.chdir(TRADER_DIR)    # Change working directory
         self.init_engines()     # Initialize function engines
 
@@ -71,8 +109,12 @@ class MainEngine:
         """
         Add function engine.
         """
+        start: float = perf_counter()
+
         engine: BaseEngine = engine_class(self, self.event_engine)
         self.engines[engine.engine_name] = engine
+
+        self.record_timeline(engine.engine_name, start)
         return engine
 
     def add_gateway(self, gateway_class: Type[BaseGateway], gateway_name: str = "") -> BaseGateway:
@@ -83,9 +125,23 @@ class MainEngine:
         if not gateway_name:
             gateway_name: str = gateway_class.default_name
 
+        start: float = perf_counter()
+
         gateway: BaseGateway = gateway_class(self.event_engine, gateway_name)
         self.gateways[gateway_name] = gateway
 
+        # Load cached contracts into OMS in bulk, and push them as one
+        # batch event, as gateway will not push contracts same as cached
+        if SETTINGS["contract.cache"]:
+            contracts: List[ContractData] = gateway.init_contract_cache()
+            if contracts:
+                oms_engine: OmsEngine = self.engines["oms"]
+                oms_engine.update_contracts(contracts)
+
+                gateway.on_event(EVENT_CONTRACTS, contracts)
+
+        self.record_timeline(gateway_name, start)
+
         # Add gateway supported exchanges into engine
         for exchange in gateway.exchanges:
             if exchange not in self.exchanges:
@@ -93,23 +149,99 @@ class MainEngine:
 
         return gateway
 
-    def add_app(self, app_class: Type[BaseApp]) -> "BaseEngine":
+    def add_app(self, app_class: Type[BaseApp], lazy: bool = False) -> Optional["BaseEngine"]:
         """
         Add app.
+
+        If lazy, app engine is not created until get_engine called with
+        app name or init_apps called, and None is returned.
         """
         app: BaseApp = app_class()
         self.apps[app.app_name] = app
 
-        engine: BaseEngine = self.add_engine(app.engine_class)
+        self.pending_apps[app.app_name] = app
+        self.app_locks[app.app_name] = RLock()
+
+        if lazy:
+            return None
+
+        engine: BaseEngine = self.init_app(app.app_name)
         return engine
 
+    def init_app(self, app_name: str, chain: Tuple[str, ...] = ()) -> Optional["BaseEngine"]:
+        """
+        Create engine of app after those of apps it depends on.
+
+        Return None if app already initialized.
+        """
+        lock: Optional[RLock] = self.app_locks.get(app_name, None)
+        if not lock:
+            return None
+
+        with lock:
+            app: Optional[BaseApp] = self.pending_apps.get(app_name, None)
+            if not app:
+                return None
+
+            # Apps in the chain are being initialized, skip to avoid circular dependency
+            chain += (app_name,)
+            for depend_name in app.depends:
+                if depend_name not in chain:
+                    self.init_app(depend_name, chain)
+
+            engine: BaseEngine = self.add_engine(app.engine_class)
+            self.pending_apps.pop(app_name)
+
+        return engine
+
+    def init_apps(self, max_workers: int = None) -> None:
+        """
+        Initialize all lazy apps, level by level of dependency. Apps in
+        the same level are independent and initialized in parallel.
+        """
+        with ThreadPoolExecutor(max_workers) as executor:
+            while self.pending_apps:
+                apps: List[BaseApp] = [
+                    app for app in self.pending_apps.values()
+                    if not any(name in self.pending_apps for name in app.depends)
+                ]
+
+                # Circular dependency left, initialize one by one
+                if not apps:
+                    apps = list(self.pending_apps.values())[:1]
+
+                names: List[str] = [app.app_name for app in apps]
+                list(executor.map(self.init_app, names))
+
+    def record_timeline(self, name: str, start: float) -> None:
+        """
+        Record start time and cost of a startup stage.
+        """
+        item: tuple = (name, start - self.start_time, perf_counter() - start, current_thread().name)
+        self.timeline.append(item)
+
+    def get_startup_report(self) -> str:
+        """
+        Get startup timeline of engines and gateways in text.
+        """
+        lines: List[str] = [_("开始(ms)    耗时(ms)    线程    名称")]
+
+        for name, start, cost, thread_name in sorted(self.timeline, key=lambda item: item[1]):
+            lines.append(f"{start * 1000:>8.1f}    {cost * 1000:>8.1f}    {thread_name}    {name}")
+
+        return "\n".join(lines)
+
     def init_engines(self) -> None:
         """
         Init all engines.
         """
         self.add_engine(LogEngine)
         self.add_engine(OmsEngine)
+        self.add_engine(StopOrderEngine)
         self.add_engine(EmailEngine)
+        self.add_engine(TraceEngine)
+        self.add_engine(ProfileEngine)
+        self.add_engine(JournalEngine)
 
     def write_log(self, msg: str, source: str = "") -> None:
         """
@@ -132,6 +264,9 @@ class MainEngine:
         """
         Return engine object by name.
         """
+        if engine_name in self.pending_apps:
+            self.init_app(engine_name)
+
         engine: BaseEngine = self.engines.get(engine_name, None)
         if not engine:
             self.write_log(_("找不到引擎：{}").format(engine_name))
@@ -234,12 +369,17 @@ class MainEngine:
         # Stop event engine first to prevent new timer event.
         self.event_engine.stop()
 
-        for engine in self.engines.values():
+        # Close engines in reverse order of adding, so that hooks chained
+        # by engines are removed from the top.
+        for engine in reversed(list(self.engines.values())):
             engine.close()
 
         for gateway in self.gateways.values():
             gateway.close()
 
+            if gateway.contract_cache:
+                gateway.contract_cache.save()
+
 
 class BaseEngine(ABC):
     """
@@ -264,33 +404,51 @@ class BaseEngine(ABC):
 
 class LogEngine(BaseEngine):
     """
-    Processes log event and output with logging module.
+    Processes log event and output to console and file.
+
+    Log records are formatted in event engine thread and appended into
+    a ring buffer, then written out in batch by a dedicated writer thread,
+    so that slow console or disk output never blocks event processing.
+    Records are also passed to handlers added to "veighna" logger from
+    the writer thread.
     """
 
+    flush_interval: float = 0.5         # Max seconds before buffered records written
+
     def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
         """"""
         super(LogEngine, self).__init__(main_engine, event_engine, "log")
 
+        self.active: bool = False
+
         if not SETTINGS["log.active"]:
             return
 
         self.level: int = SETTINGS["log.level"]
+        self.fsync: bool = SETTINGS["log.fsync"]
 
         self.logger: Logger = logging.getLogger("veighna")
         self.logger.setLevel(self.level)
 
-        self.formatter: logging.Formatter = logging.Formatter(
-            "%(asctime)s  %(levelname)s: %(message)s"
-        )
-
         self.add_null_handler()
 
+        # Appending to and popping from deque are atomic operations,
+        # so no lock is required between event thread and writer thread.
+        self.buffer: deque = deque()
+        self.signal: TEvent = TEvent()
+
+        self.console: Optional[TextIO] = None
         if SETTINGS["log.console"]:
             self.add_console_handler()
 
+        self.file: Optional[TextIO] = None
         if SETTINGS["log.file"]:
             self.add_file_handler()
 
+        self.active = True
+        self.thread: Thread = Thread(target=self.run, daemon=True)
+        self.thread.start()
+
         self.register_event()
 
     def add_null_handler(self) -> None:
@@ -302,28 +460,20 @@ class LogEngine(BaseEngine):
 
     def add_console_handler(self) -> None:
         """
-        Add console output of log.
+        Add console output of log, written by writer thread.
         """
-        console_handler: logging.StreamHandler = logging.StreamHandler()
-        console_handler.setLevel(self.level)
-        console_handler.setFormatter(self.formatter)
-        self.logger.addHandler(console_handler)
+        self.console = sys.stderr
 
     def add_file_handler(self) -> None:
         """
-        Add file output of log.
+        Open file for log output.
         """
         today_date: str = datetime.now().strftime("%Y%m%d")
         filename: str = f"vt_{today_date}.log"
         log_path: Path = get_folder_path("log")
         file_path: Path = log_path.joinpath(filename)
 
-        file_handler: logging.FileHandler = logging.FileHandler(
-            file_path, mode="a", encoding="utf8"
-        )
-        file_handler.setLevel(self.level)
-        file_handler.setFormatter(self.formatter)
-        self.logger.addHandler(file_handler)
+        self.file = open(file_path, mode="a", encoding="utf8")
 
     def register_event(self) -> None:
         """"""
@@ -334,7 +484,101 @@ class LogEngine(BaseEngine):
         Process log event.
         """
         log: LogData = event.data
-        self.logger.log(log.level, log.msg)
+        if log.level < self.level:
+            return
+
+        time_str: str = log.time.strftime("%Y-%m-%d %H:%M:%S")
+        millisecond: int = log.time.microsecond // 1000
+        level_name: str = logging.getLevelName(log.level)
+
+        self.buffer.append((f"{time_str},{millisecond:03d}  {level_name}: {log.msg}\n", log))
+        self.signal.set()
+
+    def run(self) -> None:
+        """
+        Write buffered log records in batch.
+        """
+        while self.active:
+            self.signal.wait(self.flush_interval)
+            self.signal.clear()
+            self.write()
+
+        self.write()
+
+    def write(self) -> None:
+        """
+        Write all buffered records out.
+        """
+        records: List[Tuple[str, LogData]] = []
+        buffer: deque = self.buffer
+
+        while buffer:
+            records.append(buffer.popleft())
+
+        if not records:
+            return
+        text: str = "".join([line for line, _log in records])
+
+        if self.console:
+            self.console.write(text)
+            self.console.flush()
+
+        if self.file:
+            self.file.write(text)
+            self.file.flush()
+
+            if self.fsync:
+                os.fsync(self.file.fileno())
+
+        if self.has_handlers():
+            for _line, log in records:
+                self.emit_record(log)
+
+    def has_handlers(self) -> bool:
+        """
+        Check if any handler other than null handler can receive records
+        of logger, including handlers of parent loggers.
+        """
+        logger: Optional[Logger] = self.logger
+
+        while logger:
+            for handler in logger.handlers:
+                if not isinstance(handler, logging.NullHandler):
+                    return True
+
+            if not logger.propagate:
+                break
+            logger = logger.parent
+
+        return False
+
+    def emit_record(self, log: LogData) -> None:
+        """
+        Pass log data to handlers of logger as log record.
+        """
+        record: logging.LogRecord = self.logger.makeRecord(
+            self.logger.name, log.level, "", 0, log.msg, (), None,
+            extra={"gateway_name": log.gateway_name}
+        )
+        record.created = log.time.timestamp()
+        record.msecs = log.time.microsecond / 1000
+
+        self.logger.handle(record)
+
+    def close(self) -> None:
+        """
+        Stop writer thread after all records written.
+        """
+        if not self.active:
+            return
+
+        self.active = False
+        self.signal.set()
+        self.thread.join()
+
+        if self.file:
+            self.file.close()
+            self.file = None
 
 
 class OmsEngine(BaseEngine):
@@ -359,6 +603,8 @@ class OmsEngine(BaseEngine):
 
         self.offset_converters: Dict[str, OffsetConverter] = {}
 
+        self.chain_index: ChainIndex = ChainIndex()
+
         self.add_function()
         self.register_event()
 
@@ -386,6 +632,10 @@ class OmsEngine(BaseEngine):
         self.main_engine.convert_order_request = self.convert_order_request
         self.main_engine.get_converter = self.get_converter
 
+        self.main_engine.get_option_portfolios = self.get_option_portfolios
+        self.main_engine.get_option_chain = self.get_option_chain
+        self.main_engine.get_option_chains = self.get_option_chains
+
     def register_event(self) -> None:
         """"""
         self.event_engine.register(EVENT_TICK, self.process_tick_event)
@@ -395,12 +645,16 @@ class OmsEngine(BaseEngine):
         self.event_engine.register(EVENT_ACCOUNT, self.process_account_event)
         self.event_engine.register(EVENT_CONTRACT, self.process_contract_event)
         self.event_engine.register(EVENT_QUOTE, self.process_quote_event)
+        self.event_engine.register(EVENT_CONTRACTS, self.process_contracts_event)
+        self.event_engine.register(EVENT_POSITIONS, self.process_positions_event)
 
     def process_tick_event(self, event: Event) -> None:
         """"""
         tick: TickData = event.data
         self.ticks[tick.vt_symbol] = tick
 
+        self.chain_index.update_tick(tick)
+
     def process_order_event(self, event: Event) -> None:
         """"""
         order: OrderData = event.data
@@ -431,6 +685,7 @@ class OmsEngine(BaseEngine):
     def process_position_event(self, event: Event) -> None:
         """"""
         position: PositionData = event.data
+
         self.positions[position.vt_positionid] = position
 
         # Update to offset converter
@@ -438,6 +693,25 @@ class OmsEngine(BaseEngine):
         if converter:
             converter.update_position(position)
 
+    def process_positions_event(self, event: Event) -> None:
+        """
+        Update batch of positions pushed by gateway in one pass.
+        """
+        positions: List[PositionData] = event.data
+        self.positions.update({p.vt_positionid: p for p in positions})
+
+        # Update to offset converter
+        gateway_name: str = ""
+        converter: Optional[OffsetConverter] = None
+
+        for position in positions:
+            if position.gateway_name != gateway_name:
+                gateway_name = position.gateway_name
+                converter = self.offset_converters.get(gateway_name, None)
+
+            if converter:
+                converter.update_position(position)
+
     def process_account_event(self, event: Event) -> None:
         """"""
         account: AccountData = event.data
@@ -446,12 +720,35 @@ class OmsEngine(BaseEngine):
     def process_contract_event(self, event: Event) -> None:
         """"""
         contract: ContractData = event.data
+
         self.contracts[contract.vt_symbol] = contract
 
+        self.chain_index.add_contract(contract)
+
         # Initialize offset converter for each gateway
         if contract.gateway_name not in self.offset_converters:
             self.offset_converters[contract.gateway_name] = OffsetConverter(self)
 
+    def process_contracts_event(self, event: Event) -> None:
+        """
+        Update batch of contracts pushed by gateway in one pass.
+        """
+        self.update_contracts(event.data)
+
+    def update_contracts(self, contracts: List[ContractData]) -> None:
+        """
+        Update contracts in bulk, such as those loaded from cache.
+        """
+        self.contracts.update({c.vt_symbol: c for c in contracts})
+
+        for contract in contracts:
+            self.chain_index.add_contract(contract)
+
+        # Initialize offset converter for each gateway
+        for gateway_name in {c.gateway_name for c in contracts}:
+            if gateway_name not in self.offset_converters:
+                self.offset_converters[gateway_name] = OffsetConverter(self)
+
     def process_quote_event(self, event: Event) -> None:
         """"""
         quote: QuoteData = event.data
@@ -610,12 +907,241 @@ class OmsEngine(BaseEngine):
         """
         return self.offset_converters.get(gateway_name, None)
 
+    def get_option_portfolios(self) -> List[str]:
+        """
+        Get names of all option portfolios.
+        """
+        return self.chain_index.get_portfolios()
+
+    def get_option_chain(self, portfolio: str, expiry: Optional[date]) -> Optional[OptionChain]:
+        """
+        Get option chain of portfolio by expiry date.
+        """
+        return self.chain_index.get_chain(portfolio, expiry)
+
+    def get_option_chains(self, portfolio: str) -> List[OptionChain]:
+        """
+        Get all option chains of portfolio sorted by expiry.
+        """
+        return self.chain_index.get_chains(portfolio)
+
+
+class StopOrderEngine(BaseEngine):
+    """
+    Provides local stop order function.
+
+    Waiting stop orders are kept in price-sorted books of each vt_symbol,
+    so that each tick only triggers crossed orders without scanning all
+    of them. Triggered orders are sent as limit orders through offset
+    converter of the gateway.
+    """
+
+    def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
+        """"""
+        super(StopOrderEngine, self).__init__(main_engine, event_engine, "stop")
+
+        self.stop_order_count: int = 0
+        self.stop_orders: Dict[str, StopOrderData] = {}
+        self.active_stop_orders: Dict[str, StopOrderData] = {}
+        self.books: Dict[str, StopOrderBook] = {}
+
+        self.lock: RLock = RLock()
+
+        self.add_function()
+
+    def add_function(self) -> None:
+        """Add query function to main engine."""
+        self.main_engine.send_stop_order = self.send_stop_order
+        self.main_engine.cancel_stop_order = self.cancel_stop_order
+        self.main_engine.get_stop_order = self.get_stop_order
+        self.main_engine.get_all_active_stop_orders = self.get_all_active_stop_orders
+
+    def send_stop_order(
+        self,
+        req: OrderRequest,
+        gateway_name: str,
+        lock: bool = False,
+        net: bool = False
+    ) -> str:
+        """
+        Create local stop order with price of request as stop price.
+        """
+        contract: Optional[ContractData] = self.main_engine.get_contract(req.vt_symbol)
+        if not contract:
+            self.main_engine.write_log(_("停止单发送失败，找不到合约：{}").format(req.vt_symbol), "STOP")
+            return ""
+
+        with self.lock:
+            self.stop_order_count += 1
+            stop_orderid: str = f"STOP.{self.stop_order_count}"
+
+            stop_order: StopOrderData = StopOrderData(
+                symbol=req.symbol,
+                exchange=req.exchange,
+                stop_orderid=stop_orderid,
+                direction=req.direction,
+                offset=req.offset,
+                price=round_to(req.price, contract.pricetick),
+                volume=req.volume,
+                datetime=datetime.now(),
+                reference=req.reference,
+                lock=lock,
+                net=net,
+                gateway_name=gateway_name
+            )
+            self.stop_orders[stop_orderid] = stop_order
+            self.active_stop_orders[stop_orderid] = stop_order
+
+            book: Optional[StopOrderBook] = self.books.get(req.vt_symbol, None)
+            if book is None:
+                book = StopOrderBook()
+                self.books[req.vt_symbol] = book
+                self.event_engine.register(EVENT_TICK + req.vt_symbol, self.process_tick_event)
+
+            book.add(stop_orderid, stop_order.direction, stop_order.price)
+
+        self.put_event(stop_order)
+        return stop_orderid
+
+    def cancel_stop_order(self, stop_orderid: str) -> None:
+        """
+        Cancel waiting stop order.
+        """
+        with self.lock:
+            stop_order: Optional[StopOrderData] = self.active_stop_orders.pop(stop_orderid, None)
+            if not stop_order:
+                return
+
+            self.books[stop_order.vt_symbol].remove(stop_orderid)
+            stop_order.status = StopOrderStatus.CANCELLED
+
+        self.put_event(stop_order)
+
+    def process_tick_event(self, event: Event) -> None:
+        """
+        Trigger stop orders crossed by last price of tick.
+        """
+        tick: TickData = event.data
+
+        # Ticks without last price (e.g. before open) never trigger
+        if not tick.last_price:
+            return
+
+        with self.lock:
+            book: StopOrderBook = self.books[tick.vt_symbol]
+            if not book:
+                return
+
+            stop_orderids: List[str] = book.match(tick.last_price)
+            if not stop_orderids:
+                return
+
+            stop_orders: List[StopOrderData] = [
+                self.active_stop_orders.pop(stop_orderid) for stop_orderid in stop_orderids
+            ]
+
+        for stop_order in stop_orders:
+            self.trigger_stop_order(stop_order, tick)
+
+    def trigger_stop_order(self, stop_order: StopOrderData, tick: TickData) -> None:
+        """
+        Send limit order of triggered stop order.
+        """
+        if stop_order.direction == Direction.LONG:
+            price: float = tick.limit_up or tick.ask_price_5 or tick.ask_price_1
+        else:
+            price = tick.limit_down or tick.bid_price_5 or tick.bid_price_1
+
+        contract: ContractData = self.main_engine.get_contract(stop_order.vt_symbol)
+        price = round_to(price or tick.last_price, contract.pricetick)
+
+        req: OrderRequest = OrderRequest(
+            symbol=stop_order.symbol,
+            exchange=stop_order.exchange,
+            direction=stop_order.direction,
+            type=OrderType.LIMIT,
+            volume=stop_order.volume,
+            price=price,
+            offset=stop_order.offset,
+            reference=stop_order.reference
+        )
+
+        gateway_name: str = stop_order.gateway_name
+        reqs: List[OrderRequest] = self.main_engine.convert_order_request(
+            req, gateway_name, stop_order.lock, stop_order.net
+        )
+
+        # No order to send (e.g. no position to close), stop order is cancelled
+        if not reqs:
+            msg: str = _("停止单{}触发失败，委托转换结果为空，已撤销").format(stop_order.stop_orderid)
+            self.main_engine.write_log(msg, "STOP")
+
+            stop_order.status = StopOrderStatus.CANCELLED
+            self.put_event(stop_order)
+            return
+
+        for req in reqs:
+            vt_orderid: str = self.main_engine.send_order(req, gateway_name)
+            if not vt_orderid:
+                continue
+
+            stop_order.vt_orderids.append(vt_orderid)
+            self.main_engine.update_order_request(req, vt_orderid, gateway_name)
+
+        stop_order.status = StopOrderStatus.TRIGGERED
+        self.put_event(stop_order)
+
+    def put_event(self, stop_order: StopOrderData) -> None:
+        """
+        Put stop order event with a copy of data.
+        """
+        data: StopOrderData = copy(stop_order)
+        data.vt_orderids = list(stop_order.vt_orderids)
+
+        self.event_engine.put(Event(EVENT_STOP_ORDER, data))
+        self.event_engine.put(Event(EVENT_STOP_ORDER + data.stop_orderid, data))
+
+    def get_stop_order(self, stop_orderid: str) -> Optional[StopOrderData]:
+        """
+        Get stop order data by stop_orderid.
+        """
+        return self.stop_orders.get(stop_orderid, None)
+
+    def get_all_active_stop_orders(self, vt_symbol: str = "") -> List[StopOrderData]:
+        """
+        Get all waiting stop orders by vt_symbol.
+        If vt_symbol is empty, return all waiting stop orders.
+        """
+        with self.lock:
+            if not vt_symbol:
+                return list(self.active_stop_orders.values())
+            else:
+                return [
+                    stop_order
+                    for stop_order in self.active_stop_orders.values()
+                    if stop_order.vt_symbol == vt_symbol
+                ]
+
 
 class EmailEngine(BaseEngine):
     """
     Provides email sending function.
+
+    Emails are sent through a persistent authenticated connection in a
+    background thread. Emails to the same receiver arriving within batch
+    interval are merged into one digest, and the number of emails sent
+    to each receiver is limited within rate period. Emails exceeding the
+    limit are kept and merged into the next digest instead of dropped.
     """
 
+    batch_interval: float = 5           # Seconds to collect emails into one digest
+    rate_limit: int = 10                # Max emails sent to one receiver within rate period
+    rate_period: float = 60             # Seconds of rate limit period
+    retry_interval: float = 30          # Seconds to wait before retry if sending failed
+    idle_timeout: float = 60            # Seconds before closing idle connection
+    pending_limit: int = 1000           # Max emails kept for one receiver, oldest dropped
+    timeout: float = 10                 # Seconds of socket timeout for connection
+
     def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
         """"""
         super(EmailEngine, self).__init__(main_engine, event_engine, "email")
@@ -624,6 +1150,13 @@ class EmailEngine(BaseEngine):
         self.queue: Queue = Queue()
         self.active: bool = False
 
+        self.smtp: Any = None
+        self.last_used: float = 0
+
+        self.pending: Dict[str, deque] = {}
+        self.history: Dict[str, deque] = {}
+        self.flush_time: float = 0
+
         self.main_engine.send_email = self.send_email
 
     def send_email(self, subject: str, content: str, receiver: str = "") -> None:
@@ -647,19 +1180,130 @@ class EmailEngine(BaseEngine):
     def run(self) -> None:
         """"""
         while self.active:
+            timeout: float = 1
+            if self.flush_time:
+                timeout = min(timeout, max(self.flush_time - monotonic(), 0))
+
             try:
-                msg: EmailMessage = self.queue.get(block=True, timeout=1)
-
-                with smtplib.SMTP_SSL(
-                    SETTINGS["email.server"], SETTINGS["email.port"]
-                ) as smtp:
-                    smtp.login(
-                        SETTINGS["email.username"], SETTINGS["email.password"]
-                    )
-                    smtp.send_message(msg)
+                msg: EmailMessage = self.queue.get(block=True, timeout=timeout)
+                self.add_pending(msg)
             except Empty:
                 pass
 
+            now: float = monotonic()
+
+            if self.flush_time and now >= self.flush_time:
+                self.flush_time = self.send_pending(now)
+
+            if self.smtp and now - self.last_used > self.idle_timeout:
+                self.disconnect()
+
+        # Send all remaining emails before exit
+        while not self.queue.empty():
+            self.add_pending(self.queue.get())
+
+        self.send_pending(monotonic(), force=True)
+        self.disconnect()
+
+    def add_pending(self, msg: EmailMessage) -> None:
+        """
+        Add email into pending queue of its receiver.
+        """
+        receiver: str = msg["To"]
+
+        queue: Optional[deque] = self.pending.get(receiver, None)
+        if queue is None:
+            queue = deque(maxlen=self.pending_limit)
+            self.pending[receiver] = queue
+        queue.append(msg)
+
+        if not self.flush_time:
+            self.flush_time = monotonic() + self.batch_interval
+
+    def send_pending(self, now: float, force: bool = False) -> float:
+        """
+        Send digest of pending emails to each receiver allowed by rate
+        limit. Return time of next sending, or 0 if nothing pending.
+        """
+        next_time: float = 0
+
+        for receiver, queue in list(self.pending.items()):
+            history: Optional[deque] = self.history.get(receiver, None)
+            if history is None:
+                history = deque()
+                self.history[receiver] = history
+
+            while history and now - history[0] >= self.rate_period:
+                history.popleft()
+
+            if len(history) >= self.rate_limit and not force:
+                retry_time: float = history[0] + self.rate_period
+            elif self.deliver(create_digest(list(queue))):
+                history.append(now)
+                self.pending.pop(receiver)
+                continue
+            else:
+                retry_time = now + self.retry_interval
+
+            if not next_time or retry_time < next_time:
+                next_time = retry_time
+
+        return next_time
+
+    def deliver(self, msg: EmailMessage) -> bool:
+        """
+        Send email with current connection, reconnect once if failed.
+        """
+        # Imported here to save startup time if email never sent
+        import smtplib
+
+        for _attempt in range(2):
+            try:
+                if not self.smtp:
+                    self.connect()
+
+                self.smtp.send_message(msg)
+                self.last_used = monotonic()
+                return True
+            except (smtplib.SMTPException, OSError) as ex:
+                self.disconnect()
+                error: Exception = ex
+
+        self.main_engine.write_log(_("邮件发送失败：{}").format(error), "EMAIL")
+        return False
+
+    def connect(self) -> None:
+        """
+        Create connection to SMTP server and login.
+        """
+        import smtplib
+
+        server: str = SETTINGS["email.server"]
+        port: int = SETTINGS["email.port"]
+
+        if SETTINGS["email.ssl"]:
+            self.smtp = smtplib.SMTP_SSL(server, port, timeout=self.timeout)
+        else:
+            self.smtp = smtplib.SMTP(server, port, timeout=self.timeout)
+
+        # Login is skipped for server without authentication
+        if SETTINGS["email.username"]:
+            self.smtp.login(SETTINGS["email.username"], SETTINGS["email.password"])
+
+        self.last_used = monotonic()
+
+    def disconnect(self) -> None:
+        """"""
+        if not self.smtp:
+            return
+
+        try:
+            self.smtp.quit()
+        except Exception:
+            self.smtp.close()
+
+        self.smtp = None
+
     def start(self) -> None:
         """"""
         self.active = True
@@ -672,3 +1316,107 @@ class EmailEngine(BaseEngine):
 
         self.active = False
         self.thread.join()
+
+
+def create_digest(msgs: List[EmailMessage]) -> EmailMessage:
+    """
+    Merge emails to the same receiver into one digest email.
+    """
+    if len(msgs) == 1:
+        return msgs[0]
+
+    last: EmailMessage = msgs[-1]
+
+    digest: EmailMessage = EmailMessage()
+    digest["From"] = last["From"]
+    digest["To"] = last["To"]
+    digest["Subject"] = f"[{len(msgs)}] {last['Subject']}"
+
+    parts: List[str] = [f"{msg['Subject']}\n{msg.get_content()}" for msg in msgs]
+    digest.set_content(f"\n{'-' * 40}\n".join(parts))
+
+    return digest
+
+
+class JournalEngine(BaseEngine):
+    """
+    Records events into binary journal files for post-trade analysis.
+    """
+
+    def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
+        """"""
+        super(JournalEngine, self).__init__(main_engine, event_engine, "journal")
+
+        self.journal: Optional[EventJournal] = None
+
+        if not SETTINGS["journal.active"]:
+            return
+
+        self.journal = EventJournal(event_engine, get_folder_path("journal"), on_error=self.process_error)
+        self.journal.start()
+
+    def process_error(self, event: Event, ex: Exception) -> None:
+        """"""
+        self.main_engine.write_log(_("事件日志记录失败，事件类型{}：{}").format(event.type, ex), "JOURNAL")
+
+    def close(self) -> None:
+        """"""
+        if self.journal:
+            self.journal.close()
+
+
+class TraceEngine(BaseEngine):
+    """
+    Traces latency from tick receiving to order sending.
+
+    Tracer chains to dispatch function of event engine, so it can be
+    stacked with journal and is unhooked in reverse order on close.
+    """
+
+    def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
+        """"""
+        super(TraceEngine, self).__init__(main_engine, event_engine, "trace")
+
+        self.tracer: Optional[LatencyTracer] = None
+
+        if not SETTINGS["trace.active"]:
+            return
+
+        self.tracer = LatencyTracer(main_engine, event_engine)
+        self.tracer.start()
+
+    def get_report(self) -> dict:
+        """
+        Get latency summary of all stages and dispatching of event types.
+        """
+        if not self.tracer:
+            return {}
+        return self.tracer.get_report()
+
+    def close(self) -> None:
+        """"""
+        if self.tracer:
+            self.tracer.close()
+
+
+class ProfileEngine(BaseEngine):
+    """
+    Runs sampling profiler and dumps results into profile folder.
+    """
+
+    def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
+        """"""
+        super(ProfileEngine, self).__init__(main_engine, event_engine, "profile")
+
+        self.profiler: Optional[SamplingProfiler] = None
+
+        if not SETTINGS["profile.active"]:
+            return
+
+        self.profiler = SamplingProfiler(get_folder_path("profile"), SETTINGS["profile.memory"])
+        self.profiler.start()
+
+    def close(self) -> None:
+        """"""
+        if self.profiler:
+            self.profiler.close()
@@ -11,4 +11,13 @@ EVENT_POSITION = "ePosition."
 EVENT_ACCOUNT = "eAccount."
 EVENT_QUOTE = "eQuote."
 EVENT_CONTRACT = "eContract."
+EVENT_STOP_ORDER = "eStopOrder."
+EVENT_ALGO = "eAlgo."
+EVENT_ALGO_TIMER = "eAlgoTimer"
+EVENT_SPREAD_CALC = "eSpreadCalc"
+EVENT_QUOTE_FLUSH = "eQuoteFlush"
 EVENT_LOG = "eLog"
+
+# Batch events with a list of data objects
+EVENT_CONTRACTS = "eContracts"
+EVENT_POSITIONS = "ePositions"
@@ -12,6 +12,8 @@ from .event import (
     EVENT_CONTRACT,
     EVENT_LOG,
     EVENT_QUOTE,
+    EVENT_CONTRACTS,
+    EVENT_POSITIONS,
 )
 from .object import (
     TickData,
@@ -30,6 +32,7 @@ from .object import (
     Exchange,
     BarData
 )
+from .cache import ContractCache
 
 
 class BaseGateway(ABC):
@@ -62,6 +65,9 @@ class BaseGateway(ABC):
     * on_account
     * on_contract
 
+    Gateway can also push query results in batch with on_contracts and
+    on_positions, which generate one event for all data in the list.
+
     All the XxxData passed to callback should be constant, which means that
         the object should not be modified after passing to on_xxxx.
     So if you use a cache to store reference of data, use copy.copy to create a new object
@@ -85,6 +91,8 @@ class BaseGateway(ABC):
         self.event_engine: EventEngine = event_engine
         self.gateway_name: str = gateway_name
 
+        self.contract_cache: Optional[ContractCache] = None
+
     def on_event(self, type: str, data: Any = None) -> None:
         """
         General event push.
@@ -124,6 +132,16 @@ class BaseGateway(ABC):
         self.on_event(EVENT_POSITION, position)
         self.on_event(EVENT_POSITION + position.vt_symbol, position)
 
+    def on_positions(self, positions: List[PositionData]) -> None:
+        """
+        Batch position event push, such as result of position query.
+
+        Only one batch event is put into queue, records are dispatched to
+        position event handlers by event engine when batch is processed.
+        """
+        if positions:
+            self.on_event(EVENT_POSITIONS, positions)
+
     def on_account(self, account: AccountData) -> None:
         """
         Account event push.
@@ -149,9 +167,34 @@ class BaseGateway(ABC):
     def on_contract(self, contract: ContractData) -> None:
         """
         Contract event push.
+        Contract same as cached is not pushed again.
         """
+        if self.contract_cache and not self.contract_cache.update_contract(contract):
+            return
+
         self.on_event(EVENT_CONTRACT, contract)
 
+    def on_contracts(self, contracts: List[ContractData]) -> None:
+        """
+        Batch contract event push, such as result of contract query.
+        Contracts same as cached are not pushed again.
+
+        Only one batch event is put into queue, records are dispatched to
+        contract event handlers by event engine when batch is processed.
+        """
+        if self.contract_cache:
+            contracts = [c for c in contracts if self.contract_cache.update_contract(c)]
+
+        if contracts:
+            self.on_event(EVENT_CONTRACTS, contracts)
+
+    def init_contract_cache(self) -> List[ContractData]:
+        """
+        Enable contract cache and return contracts loaded from it.
+        """
+        self.contract_cache = ContractCache(self.gateway_name)
+        return self.contract_cache.load()
+
     def write_log(self, msg: str) -> None:
         """
         Write a log event from gateway.
@@ -168,9 +211,9 @@ class BaseGateway(ABC):
         * connect to server if necessary
         * log connected if all necessary connection is established
         * do the following query and response corresponding on_xxxx and write_log
-            * contracts : on_contract
+            * contracts : on_contract or on_contracts
             * account asset : on_account
-            * account holding: on_position
+            * account holding: on_position or on_positions
             * orders of account: on_order
             * trades of account: on_trade
         * if any of query above is failed,  write log.
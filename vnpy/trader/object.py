@@ -6,7 +6,19 @@ from dataclasses import dataclass, field
 from datetime import datetime
 from logging import INFO
 
-from .constant import Direction, Exchange, Interval, Offset, Status, Product, OptionType, OrderType
+from vnpy.event import get_clock
+
+from .constant import (
+    Direction,
+    Exchange,
+    Interval,
+    Offset,
+    Status,
+    Product,
+    OptionType,
+    OrderType,
+    StopOrderStatus
+)
 
 ACTIVE_STATUSES = set([Status.SUBMITTING, Status.NOTTRADED, Status.PARTTRADED])
 
@@ -223,7 +235,7 @@ class LogData(BaseData):
 
     def __post_init__(self) -> None:
         """"""
-        self.time: datetime = datetime.now()
+        self.time: datetime = get_clock().now()
 
 
 @dataclass
@@ -299,6 +311,39 @@ class QuoteData(BaseData):
         return req
 
 
+@dataclass
+class StopOrderData(BaseData):
+    """
+    Local stop order, which sends limit order when market price
+    crosses stop price.
+    """
+
+    symbol: str
+    exchange: Exchange
+    stop_orderid: str
+
+    direction: Direction = None
+    offset: Offset = Offset.NONE
+    price: float = 0
+    volume: float = 0
+    status: StopOrderStatus = StopOrderStatus.WAITING
+    datetime: datetime = None
+    reference: str = ""
+    lock: bool = False
+    net: bool = False
+    vt_orderids: list = field(default_factory=list)
+
+    def __post_init__(self) -> None:
+        """"""
+        self.vt_symbol: str = f"{self.symbol}.{self.exchange.value}"
+
+    def is_active(self) -> bool:
+        """
+        Check if the stop order is waiting for trigger.
+        """
+        return self.status == StopOrderStatus.WAITING
+
+
 @dataclass
 class SubscribeRequest:
     """
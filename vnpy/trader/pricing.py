@@ -0,0 +1,531 @@
+"""
+Vectorized option pricing models and implied volatility solver.
+
+All functions accept numpy arrays (or scalars) of the same shape for
+each parameter, and calculate the whole batch in numpy operations. Option
+type is given as cp, 1 for call and -1 for put.
+"""
+
+from datetime import datetime, time
+from typing import Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+
+from vnpy.event import get_clock
+
+from .constant import OptionType
+from .object import ContractData
+
+
+SQRT_2PI: float = np.sqrt(2 * np.pi)
+YEAR_SECONDS: float = 365 * 24 * 60 * 60
+
+MIN_VOLATILITY: float = 1e-4
+MAX_VOLATILITY: float = 5.0
+
+
+def norm_pdf(x: np.ndarray) -> np.ndarray:
+    """
+    Standard normal probability density.
+    """
+    return np.exp(-0.5 * x * x) / SQRT_2PI
+
+
+def norm_cdf(x: np.ndarray) -> np.ndarray:
+    """
+    Standard normal cumulative distribution with double precision,
+    using Hart's rational approximation (Algorithm 5666).
+    """
+    x = np.asarray(x, dtype=float)
+    z: np.ndarray = np.abs(x)
+    e: np.ndarray = np.exp(-0.5 * z * z)
+
+    n: np.ndarray = 0.0352624965998911 * z + 0.700383064443688
+    n = n * z + 6.37396220353165
+    n = n * z + 33.912866078383
+    n = n * z + 112.079291497871
+    n = n * z + 221.213596169931
+    n = n * z + 220.206867912376
+
+    d: np.ndarray = 0.0883883476483184 * z + 1.75566716318264
+    d = d * z + 16.064177579207
+    d = d * z + 86.7807322029461
+    d = d * z + 296.564248779674
+    d = d * z + 637.333633378831
+    d = d * z + 793.826512519948
+    d = d * z + 440.413735824752
+
+    # Continued fraction for the far tail
+    with np.errstate(divide="ignore", invalid="ignore"):
+        b: np.ndarray = z + 0.65
+        b = z + 4 / b
+        b = z + 3 / b
+        b = z + 2 / b
+        b = z + 1 / b
+
+        tail: np.ndarray = np.where(z < 7.07106781186547, e * n / d, e / b / SQRT_2PI)
+
+    tail = np.where(z > 37, 0.0, tail)
+    return np.where(x > 0, 1 - tail, tail)
+
+
+def black76_price(
+    f: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    v: np.ndarray,
+    cp: np.ndarray
+) -> np.ndarray:
+    """
+    Black-76 price of options on futures.
+    """
+    return black76_greeks(f, k, t, r, v, cp)["price"]
+
+
+def black76_greeks(
+    f: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    v: np.ndarray,
+    cp: np.ndarray
+) -> Dict[str, np.ndarray]:
+    """
+    Black-76 price and greeks of options on futures.
+
+    Delta and gamma are with respect to futures price, vega is per 1.0
+    volatility and theta is per year. Expired options or options with
+    zero volatility are valued at discounted intrinsic value.
+    """
+    f, k, t, r, v, cp = np.broadcast_arrays(*[np.asarray(a, dtype=float) for a in (f, k, t, r, v, cp)])
+
+    df: np.ndarray = np.exp(-r * np.maximum(t, 0))
+    live: np.ndarray = (t > 0) & (v > 0)
+
+    with np.errstate(divide="ignore", invalid="ignore"):
+        std: np.ndarray = v * np.sqrt(np.where(live, t, 1))
+        d1: np.ndarray = np.where(live, (np.log(f / k) + 0.5 * std * std) / std, 0)
+        d2: np.ndarray = d1 - std
+
+        nd1: np.ndarray = norm_cdf(cp * d1)
+        nd2: np.ndarray = norm_cdf(cp * d2)
+        pdf: np.ndarray = norm_pdf(d1)
+
+        price: np.ndarray = df * cp * (f * nd1 - k * nd2)
+        delta: np.ndarray = df * cp * nd1
+        gamma: np.ndarray = df * pdf / (f * std)
+        vega: np.ndarray = df * f * pdf * np.sqrt(np.where(live, t, 0))
+        theta: np.ndarray = r * price - df * f * pdf * v / (2 * np.sqrt(np.where(live, t, 1)))
+
+    intrinsic: np.ndarray = np.maximum(cp * (f - k), 0)
+    itm: np.ndarray = intrinsic > 0
+
+    return {
+        "price": np.where(live, price, df * intrinsic),
+        "delta": np.where(live, delta, np.where(itm, df * cp, 0)),
+        "gamma": np.where(live, gamma, 0),
+        "vega": np.where(live, vega, 0),
+        "theta": np.where(live, theta, 0),
+    }
+
+
+def black_scholes_price(
+    s: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    v: np.ndarray,
+    cp: np.ndarray,
+    q: np.ndarray = 0
+) -> np.ndarray:
+    """
+    Black-Scholes price of European options on spot with dividend yield q.
+    """
+    f: np.ndarray = np.asarray(s) * np.exp((np.asarray(r) - q) * np.maximum(t, 0))
+    return black76_price(f, k, t, r, v, cp)
+
+
+def black_scholes_greeks(
+    s: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    v: np.ndarray,
+    cp: np.ndarray,
+    q: np.ndarray = 0
+) -> Dict[str, np.ndarray]:
+    """
+    Black-Scholes price and greeks with respect to spot price, with
+    same units as black76_greeks.
+    """
+    s, k, t, r, v, cp, q = np.broadcast_arrays(*[np.asarray(a, dtype=float) for a in (s, k, t, r, v, cp, q)])
+
+    tau: np.ndarray = np.maximum(t, 0)
+    carry: np.ndarray = np.exp((r - q) * tau)
+    f: np.ndarray = s * carry
+
+    greeks: Dict[str, np.ndarray] = black76_greeks(f, k, t, r, v, cp)
+
+    # Convert futures greeks into spot greeks with dF/dS = carry
+    greeks["delta"] = greeks["delta"] * carry
+    greeks["gamma"] = greeks["gamma"] * carry * carry
+
+    # Spot is held constant instead of futures price for theta
+    live: np.ndarray = (t > 0) & (v > 0)
+    with np.errstate(divide="ignore", invalid="ignore"):
+        std: np.ndarray = v * np.sqrt(np.where(live, t, 1))
+        d1: np.ndarray = np.where(live, (np.log(f / k) + 0.5 * std * std) / std, 0)
+        d2: np.ndarray = d1 - std
+
+        theta: np.ndarray = (
+            -np.exp(-q * tau) * s * norm_pdf(d1) * v / (2 * np.sqrt(np.where(live, t, 1)))
+            - cp * r * k * np.exp(-r * tau) * norm_cdf(cp * d2)
+            + cp * q * s * np.exp(-q * tau) * norm_cdf(cp * d1)
+        )
+
+    greeks["theta"] = np.where(live, theta, 0)
+    return greeks
+
+
+def binomial_price(
+    s: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    v: np.ndarray,
+    cp: np.ndarray,
+    q: np.ndarray = 0,
+    steps: int = 100,
+    american: bool = True
+) -> np.ndarray:
+    """
+    Cox-Ross-Rubinstein binomial tree price, with early exercise if
+    american. For options on futures, use q equal to r.
+    """
+    return binomial_greeks(s, k, t, r, v, cp, q, steps, american, False)["price"]
+
+
+def binomial_greeks(
+    s: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    v: np.ndarray,
+    cp: np.ndarray,
+    q: np.ndarray = 0,
+    steps: int = 100,
+    american: bool = True,
+    vega: bool = True
+) -> Dict[str, np.ndarray]:
+    """
+    Binomial tree price and greeks of a batch of options.
+
+    Trees of all options are rolled back together, one column of nodes
+    for each option. Delta, gamma and theta are read from nodes of the
+    first steps, and vega is calculated with bumped volatility.
+    """
+    s, k, t, r, v, cp, q = np.broadcast_arrays(*[np.asarray(a, dtype=float) for a in (s, k, t, r, v, cp, q)])
+    shape: tuple = s.shape
+    s, k, t, r, v, cp, q = [a.reshape(-1, 1) for a in (s, k, t, r, v, cp, q)]
+
+    tau: np.ndarray = np.maximum(t, 1e-10)
+    sigma: np.ndarray = np.maximum(v, 1e-10)
+
+    dt: np.ndarray = tau / steps
+    u: np.ndarray = np.exp(sigma * np.sqrt(dt))
+    d: np.ndarray = 1 / u
+    p: np.ndarray = (np.exp((r - q) * dt) - d) / (u - d)
+    disc: np.ndarray = np.exp(-r * dt)
+
+    # Underlying price of node j at step i is s * u^(i - 2j)
+    spots: np.ndarray = s * u ** (steps - 2 * np.arange(steps + 1))
+    values: np.ndarray = np.maximum(cp * (spots - k), 0)
+
+    q_up: np.ndarray = disc * p
+    q_down: np.ndarray = disc * (1 - p)
+    layers: Dict[int, np.ndarray] = {}
+
+    for i in range(steps - 1, -1, -1):
+        values = q_up * values[:, :-1] + q_down * values[:, 1:]
+
+        if american:
+            # Each step back divides underlying price of the nodes by u
+            spots = spots[:, :-1] * d
+            np.maximum(values, cp * (spots - k), out=values)
+
+        if i <= 2:
+            layers[i] = values
+
+    price: np.ndarray = layers[0][:, 0]
+
+    v1: np.ndarray = layers[1]
+    s_up: np.ndarray = (s * u)[:, 0]
+    s_down: np.ndarray = (s * d)[:, 0]
+    delta: np.ndarray = (v1[:, 0] - v1[:, 1]) / (s_up - s_down)
+
+    v2: np.ndarray = layers[2]
+    s_uu: np.ndarray = (s * u * u)[:, 0]
+    s_dd: np.ndarray = (s * d * d)[:, 0]
+    s0: np.ndarray = s[:, 0]
+    delta_up: np.ndarray = (v2[:, 0] - v2[:, 1]) / (s_uu - s0)
+    delta_down: np.ndarray = (v2[:, 1] - v2[:, 2]) / (s0 - s_dd)
+    gamma: np.ndarray = (delta_up - delta_down) / (0.5 * (s_uu - s_dd))
+
+    theta: np.ndarray = (v2[:, 1] - price) / (2 * dt[:, 0])
+
+    greeks: Dict[str, np.ndarray] = {
+        "price": price.reshape(shape),
+        "delta": delta.reshape(shape),
+        "gamma": gamma.reshape(shape),
+        "theta": theta.reshape(shape),
+    }
+
+    if vega:
+        v_up: np.ndarray = v + 0.001
+        v_down: np.ndarray = np.maximum(v - 0.001, 0)
+        up: np.ndarray = binomial_price(s, k, t, r, v_up, cp, q, steps, american)
+        down: np.ndarray = binomial_price(s, k, t, r, v_down, cp, q, steps, american)
+        greeks["vega"] = ((up - down) / (v_up - v_down)).reshape(shape)
+
+    return greeks
+
+
+def implied_volatility(
+    price: np.ndarray,
+    f: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    cp: np.ndarray,
+    tolerance: float = 1e-8,
+    max_iterations: int = 50
+) -> np.ndarray:
+    """
+    Implied volatility of Black-76 model.
+
+    Newton iteration is used, safeguarded by bisection within a bracket
+    which always contains the solution, so that it converges for deep
+    in/out of money options where vega is tiny. Nan is returned if price
+    is outside no-arbitrage bounds.
+    """
+    price, f, k, t, r, cp = np.broadcast_arrays(*[np.asarray(a, dtype=float) for a in (price, f, k, t, r, cp)])
+
+    df: np.ndarray = np.exp(-r * np.maximum(t, 0))
+    lower_bound: np.ndarray = df * np.maximum(cp * (f - k), 0)
+    upper_bound: np.ndarray = df * np.where(cp > 0, f, k)
+    valid: np.ndarray = (t > 0) & (price > lower_bound) & (price < upper_bound)
+
+    def calculate(v: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        greeks: Dict[str, np.ndarray] = black76_greeks(f, k, t, r, v, cp)
+        return greeks["price"], greeks["vega"]
+
+    return solve_volatility(calculate, price, valid, f, t, tolerance, max_iterations)
+
+
+def implied_volatility_bs(
+    price: np.ndarray,
+    s: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    cp: np.ndarray,
+    q: np.ndarray = 0,
+    tolerance: float = 1e-8,
+    max_iterations: int = 50
+) -> np.ndarray:
+    """
+    Implied volatility of Black-Scholes model.
+    """
+    f: np.ndarray = np.asarray(s) * np.exp((np.asarray(r) - q) * np.maximum(t, 0))
+    return implied_volatility(price, f, k, t, r, cp, tolerance, max_iterations)
+
+
+def implied_volatility_binomial(
+    price: np.ndarray,
+    s: np.ndarray,
+    k: np.ndarray,
+    t: np.ndarray,
+    r: np.ndarray,
+    cp: np.ndarray,
+    q: np.ndarray = 0,
+    steps: int = 100,
+    american: bool = True,
+    tolerance: float = 1e-6,
+    max_iterations: int = 40
+) -> np.ndarray:
+    """
+    Implied volatility of binomial tree model, solved with bisection
+    safeguarded secant iteration.
+    """
+    price, s, k, t, r, cp, q = np.broadcast_arrays(*[np.asarray(a, dtype=float) for a in (price, s, k, t, r, cp, q)])
+
+    intrinsic: np.ndarray = np.maximum(cp * (s - k), 0)
+    if not american:
+        intrinsic = np.maximum(cp * (s * np.exp(-q * t) - k * np.exp(-r * t)), 0)
+    upper_bound: np.ndarray = np.where(cp > 0, s, k)
+    valid: np.ndarray = (t > 0) & (price > intrinsic) & (price < upper_bound)
+
+    def calculate(v: np.ndarray) -> Tuple[np.ndarray, None]:
+        return binomial_price(s, k, t, r, v, cp, q, steps, american), None
+
+    f: np.ndarray = s * np.exp((r - q) * np.maximum(t, 0))
+    return solve_volatility(calculate, price, valid, f, t, tolerance, max_iterations)
+
+
+def solve_volatility(
+    calculate: Callable[[np.ndarray], Tuple[np.ndarray, Optional[np.ndarray]]],
+    price: np.ndarray,
+    valid: np.ndarray,
+    f: np.ndarray,
+    t: np.ndarray,
+    tolerance: float,
+    max_iterations: int
+) -> np.ndarray:
+    """
+    Solve volatility of each option with price function of model.
+
+    Newton step is taken if vega is provided, otherwise secant step
+    with the last two points. Step outside current bracket falls back
+    to bisection.
+    """
+    low: np.ndarray = np.full(price.shape, MIN_VOLATILITY)
+    high: np.ndarray = np.full(price.shape, MAX_VOLATILITY)
+
+    # Brenner-Subrahmanyam approximation as initial guess
+    with np.errstate(divide="ignore", invalid="ignore"):
+        guess: np.ndarray = np.sqrt(2 * np.pi / np.where(t > 0, t, 1)) * price / f
+    v: np.ndarray = np.clip(np.nan_to_num(guess, nan=0.3), 0.05, 2.0)
+
+    last_v: Optional[np.ndarray] = None
+    last_diff: Optional[np.ndarray] = None
+    active: np.ndarray = valid.copy()
+
+    for _ in range(max_iterations):
+        model_price, vega = calculate(v)
+        diff: np.ndarray = model_price - price
+
+        active &= np.abs(diff) > tolerance
+        if not active.any():
+            break
+
+        # Price is increasing with volatility
+        high = np.where(active & (diff > 0), v, high)
+        low = np.where(active & (diff < 0), v, low)
+
+        with np.errstate(all="ignore"):
+            if vega is not None:
+                step_v: np.ndarray = v - diff / vega
+            elif last_v is not None:
+                step_v = v - diff * (v - last_v) / (diff - last_diff)
+            else:
+                step_v = (low + high) / 2
+
+        inside: np.ndarray = np.isfinite(step_v) & (step_v > low) & (step_v < high)
+        new_v: np.ndarray = np.where(inside, step_v, (low + high) / 2)
+
+        last_v, last_diff = v, diff
+        v = np.where(active, new_v, v)
+
+    return np.where(valid, v, np.nan)
+
+
+class OptionPricer:
+    """
+    Batch pricer of options on the same underlying.
+
+    Contract parameters are converted into arrays once, time to expiry
+    is updated when time passes, so repricing the whole chain on each
+    underlying tick is only a few numpy operations.
+
+    Options expire at session close of expiry day, if expiry provided
+    by gateway has no time of day.
+    """
+
+    expiry_close: time = time(15, 0)        # Close time of expiry day
+
+    def __init__(
+        self,
+        contracts: List[ContractData],
+        model: str = "black76",
+        r: float = 0,
+        q: float = 0,
+        steps: int = 100
+    ) -> None:
+        """
+        Model can be black76, black_scholes or binomial (American).
+        """
+        self.model: str = model
+        self.r: float = r
+        self.q: float = q
+        self.steps: int = steps
+
+        self.vt_symbols: List[str] = [c.vt_symbol for c in contracts]
+        self.indexes: Dict[str, int] = {vt_symbol: i for i, vt_symbol in enumerate(self.vt_symbols)}
+
+        self.strikes: np.ndarray = np.array([c.option_strike for c in contracts], dtype=float)
+        self.cps: np.ndarray = np.array(
+            [1 if c.option_type == OptionType.CALL else -1 for c in contracts], dtype=float
+        )
+        self.expiries: np.ndarray = np.array(
+            [self.get_expiry(c.option_expiry) for c in contracts], dtype=float
+        )
+
+        self.times: np.ndarray = np.zeros(len(contracts))
+        self.update_time()
+
+    def get_index(self, vt_symbol: str) -> Optional[int]:
+        """"""
+        return self.indexes.get(vt_symbol, None)
+
+    def get_expiry(self, expiry: Optional[datetime]) -> float:
+        """
+        Get expiry timestamp, with session close added to expiry date.
+        """
+        if not expiry:
+            return 0
+
+        if expiry.time() == time(0):
+            expiry = datetime.combine(expiry.date(), self.expiry_close, expiry.tzinfo)
+
+        return expiry.timestamp()
+
+    def update_time(self, now: datetime = None) -> None:
+        """
+        Update time to expiry in years of all options, current time of
+        global clock is used if now not given, which follows recorded
+        time during replay.
+        """
+        if now:
+            timestamp: float = now.timestamp()
+        else:
+            timestamp = get_clock().time()
+
+        self.times = np.maximum(self.expiries - timestamp, 0) / YEAR_SECONDS
+
+    def calculate(self, underlying_price: float, volatility: np.ndarray) -> Dict[str, np.ndarray]:
+        """
+        Calculate price and greeks of all options, volatility can be a
+        scalar or array of each option.
+        """
+        args: tuple = (underlying_price, self.strikes, self.times, self.r, volatility, self.cps)
+
+        if self.model == "black76":
+            return black76_greeks(*args)
+        elif self.model == "black_scholes":
+            return black_scholes_greeks(*args, self.q)
+        else:
+            return binomial_greeks(*args, self.q, self.steps)
+
+    def calculate_implied_volatility(self, underlying_price: float, prices: np.ndarray) -> np.ndarray:
+        """
+        Calculate implied volatility of all options from their prices.
+        """
+        args: tuple = (prices, underlying_price, self.strikes, self.times, self.r, self.cps)
+
+        if self.model == "black76":
+            return implied_volatility(*args)
+        elif self.model == "black_scholes":
+            return implied_volatility_bs(*args, self.q)
+        else:
+            return implied_volatility_binomial(*args, self.q, self.steps)
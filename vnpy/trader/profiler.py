@@ -0,0 +1,242 @@
+"""
+Sampling profiler attributing busy samples to event handlers, engines and threads.
+"""
+
+import json
+import queue
+import selectors
+import sys
+import threading
+import tracemalloc
+from collections import Counter
+from datetime import datetime
+from pathlib import Path
+from time import sleep, time
+from types import CodeType, FrameType
+from typing import List, Optional, Set
+
+from vnpy.event import EventEngine
+from vnpy.event.clock import VirtualClock, WallClock
+
+from .tracer import LatencyTracer
+
+
+# Functions dispatching event to handlers
+DISPATCH_CODES: Set[CodeType] = {
+    EventEngine._process.__code__,
+    LatencyTracer.process.__code__,
+}
+
+# Functions blocking thread while waiting, threads stopped in them are idle
+IDLE_CODES: Set[CodeType] = {
+    threading.Condition.wait.__code__,
+    threading.Event.wait.__code__,
+    queue.Queue.get.__code__,
+    WallClock.wait_until.__code__,
+    VirtualClock.wait_until.__code__,
+}
+
+for selector_name in ["SelectSelector", "PollSelector", "EpollSelector", "KqueueSelector", "DevpollSelector"]:
+    if hasattr(selectors, selector_name):
+        IDLE_CODES.add(getattr(selectors, selector_name).select.__code__)
+
+
+class SamplingProfiler:
+    """
+    Sample stacks of all threads periodically in a background thread.
+
+    Samples are aggregated into folded stacks, which can be rendered by
+    flame graph tools directly, and attributed to the event handler,
+    engine and thread they were taken in. Results are dumped into
+    files of folder every dump interval.
+
+    Threads whose innermost frame is a known blocking wait (queue get,
+    condition wait, selector select or clock wait) are counted as idle
+    and skipped. Shares reported are percentage of sampling rounds in
+    which a thread or handler was busy, which approximates wall time
+    share rather than CPU time, as waits in C code called by other
+    functions such as time.sleep cannot be told apart.
+    """
+
+    sample_interval: float = 0.01       # Seconds between two samples
+    dump_interval: int = 60             # Seconds between two dumps
+    memory_top: int = 50                # Number of allocation sites dumped
+
+    def __init__(self, folder: Path, memory: bool = False) -> None:
+        """
+        Allocations are traced with tracemalloc if memory is True.
+        """
+        self.folder: Path = folder
+        self.memory: bool = memory
+
+        self.stacks: Counter = Counter()
+        self.handlers: Counter = Counter()
+        self.engines: Counter = Counter()
+        self.threads: Counter = Counter()
+        self.sample_count: int = 0
+        self.idle_count: int = 0
+
+        self.active: bool = False
+        self.thread: threading.Thread = threading.Thread(target=self.run, daemon=True)
+
+    def start(self) -> None:
+        """"""
+        if self.memory:
+            tracemalloc.start()
+
+        self.active = True
+        self.thread.start()
+
+    def close(self) -> None:
+        """
+        Stop sampling and dump the last results.
+        """
+        if not self.active:
+            return
+
+        self.active = False
+        self.thread.join()
+
+        self.dump()
+
+        if self.memory:
+            tracemalloc.stop()
+
+    def run(self) -> None:
+        """"""
+        next_dump: float = time() + self.dump_interval
+
+        while self.active:
+            sleep(self.sample_interval)
+            self.sample()
+
+            if time() >= next_dump:
+                self.dump()
+                next_dump += self.dump_interval
+
+    def sample(self) -> None:
+        """
+        Take one sample of all other threads, idle threads are skipped.
+        """
+        names: dict = {t.ident: t.name for t in threading.enumerate()}
+        frames: dict = sys._current_frames()
+
+        for ident, frame in frames.items():
+            if ident == self.thread.ident:
+                continue
+
+            if frame.f_code in IDLE_CODES:
+                self.idle_count += 1
+                continue
+
+            thread_name: str = names.get(ident, str(ident))
+
+            stack: List[FrameType] = []
+            while frame:
+                stack.append(frame)
+                frame = frame.f_back
+            stack.reverse()
+
+            folded: str = ";".join([thread_name] + [get_frame_name(f) for f in stack])
+            self.stacks[folded] += 1
+            self.threads[thread_name] += 1
+
+            handler_frame: Optional[FrameType] = find_handler_frame(stack)
+            if handler_frame:
+                self.handlers[get_frame_name(handler_frame)] += 1
+
+                engine_name: str = get_engine_name(handler_frame)
+                if engine_name:
+                    self.engines[engine_name] += 1
+
+        self.sample_count += 1
+
+    def dump(self) -> None:
+        """
+        Write folded stacks, attribution summary and allocations into
+        files, then reset all counters.
+        """
+        if not self.sample_count:
+            return
+
+        timestamp: str = datetime.now().strftime("%Y%m%d_%H%M%S")
+
+        folded_path: Path = self.folder.joinpath(f"profile_{timestamp}.folded")
+        with open(folded_path, "w", encoding="utf8") as f:
+            for stack, count in self.stacks.most_common():
+                f.write(f"{stack} {count}\n")
+
+        summary: dict = {
+            "samples": self.sample_count,
+            "idle_samples": self.idle_count,
+            "interval": self.sample_interval,
+            "handlers": get_shares(self.handlers, self.sample_count),
+            "engines": get_shares(self.engines, self.sample_count),
+            "threads": get_shares(self.threads, self.sample_count),
+        }
+
+        if self.memory:
+            snapshot: tracemalloc.Snapshot = tracemalloc.take_snapshot()
+            summary["allocations"] = [
+                {"site": str(stat.traceback), "size": stat.size, "count": stat.count}
+                for stat in snapshot.statistics("lineno")[:self.memory_top]
+            ]
+
+        summary_path: Path = self.folder.joinpath(f"profile_{timestamp}.json")
+        with open(summary_path, "w", encoding="utf8") as f:
+            json.dump(summary, f, indent=4, ensure_ascii=False)
+
+        self.stacks.clear()
+        self.handlers.clear()
+        self.engines.clear()
+        self.threads.clear()
+        self.sample_count = 0
+        self.idle_count = 0
+
+
+def get_frame_name(frame: FrameType) -> str:
+    """
+    Get function name of frame with module.
+    """
+    code: CodeType = frame.f_code
+    name: str = getattr(code, "co_qualname", code.co_name)
+    module: str = frame.f_globals.get("__name__", "")
+    return f"{module}.{name}"
+
+
+def find_handler_frame(stack: List[FrameType]) -> Optional[FrameType]:
+    """
+    Find frame of the handler called by the innermost event dispatch.
+    """
+    for i in range(len(stack) - 1, -1, -1):
+        if stack[i].f_code not in DISPATCH_CODES:
+            continue
+
+        for frame in stack[i + 1:]:
+            if not frame.f_code.co_name.startswith("<"):
+                return frame
+        return None
+
+    return None
+
+
+def get_engine_name(frame: FrameType) -> str:
+    """
+    Get engine name if handler is a method of engine.
+    """
+    code: CodeType = frame.f_code
+    if not code.co_argcount:
+        return ""
+
+    obj: object = frame.f_locals.get(code.co_varnames[0], None)
+    return getattr(obj, "engine_name", "")
+
+
+def get_shares(counter: Counter, total: int) -> dict:
+    """
+    Convert busy sample counts into percentage of all sampling rounds.
+    """
+    return {
+        name: round(count / total * 100, 2)
+        for name, count in counter.most_common()
+    }
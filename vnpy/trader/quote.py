@@ -0,0 +1,356 @@
+"""
+Quote lifecycle manager reconciling desired and live two-sided quotes.
+"""
+
+from typing import Dict, Optional
+
+from vnpy.event import Event, EventEngine, EVENT_TIMER
+
+from .constant import Offset, Status
+from .engine import BaseEngine, MainEngine
+from .event import EVENT_QUOTE, EVENT_QUOTE_FLUSH
+from .object import CancelRequest, ContractData, QuoteData, QuoteRequest
+from .utility import extract_vt_symbol, round_to
+from .locale import _
+
+
+class TokenBucket:
+    """
+    Rate limiter allowing burst up to capacity and refilled at rate
+    tokens per second.
+    """
+
+    def __init__(self, rate: float, capacity: float, now: float) -> None:
+        """"""
+        self.rate: float = rate
+        self.capacity: float = capacity
+        self.tokens: float = capacity
+        self.last: float = now
+
+    def consume(self, now: float) -> bool:
+        """
+        Take one token, return False if bucket is empty.
+        """
+        self.tokens = min(self.capacity, self.tokens + (now - self.last) * self.rate)
+        self.last = now
+
+        if self.tokens < 1:
+            return False
+
+        self.tokens -= 1
+        return True
+
+
+class QuoteSlot:
+    """
+    Desired quote and live quote of one vt_symbol.
+    """
+
+    def __init__(self, contract: ContractData) -> None:
+        """"""
+        self.contract: ContractData = contract
+
+        self.target: Optional[QuoteRequest] = None
+        self.quote: Optional[QuoteData] = None
+        self.cancelling: bool = False
+        self.request_time: float = 0
+
+    def is_matched(self) -> bool:
+        """
+        Check if live quote is same as desired quote.
+        """
+        target: QuoteRequest = self.target
+        quote: QuoteData = self.quote
+
+        return (
+            target.bid_price == quote.bid_price
+            and target.bid_volume == quote.bid_volume
+            and target.ask_price == quote.ask_price
+            and target.ask_volume == quote.ask_volume
+            and target.bid_offset == quote.bid_offset
+            and target.ask_offset == quote.ask_offset
+        )
+
+
+class QuoteEngine(BaseEngine):
+    """
+    Keeps live quotes of each vt_symbol in line with desired quotes.
+
+    Desired quote can be updated at any frequency, only the latest one
+    of each symbol is kept. Symbols changed are reconciled together on
+    a flush event, sending quote or cancel request only when live quote
+    differs, and at most one request in flight for each symbol, so that
+    quick requoting does not turn into cancel/replace storm. Requests are
+    limited by token bucket of each gateway with cancels sent first,
+    symbols throttled are retried later.
+
+    Requests without response within timeout are checked on timer, so
+    that a lost response does not stop quoting of the symbol forever.
+    """
+
+    default_rate: float = 50        # requests per second of each gateway
+    default_burst: float = 100      # burst requests of each gateway
+    request_timeout: float = 10     # seconds to wait for response of request
+
+    def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
+        """"""
+        super().__init__(main_engine, event_engine, "quote")
+
+        self.slots: Dict[str, QuoteSlot] = {}
+        self.quote_symbols: Dict[str, str] = {}
+        self.buckets: Dict[str, TokenBucket] = {}
+
+        self.dirty_symbols: Dict[str, None] = {}
+        self.flush_pending: bool = False
+
+        self.send_count: int = 0
+        self.cancel_count: int = 0
+        self.throttle_count: int = 0
+
+        self.event_engine.register(EVENT_QUOTE, self.process_quote_event)
+        self.event_engine.register(EVENT_QUOTE_FLUSH, self.process_flush_event)
+        self.event_engine.register(EVENT_TIMER, self.process_timer_event)
+
+        self.main_engine.set_quote = self.set_quote
+        self.main_engine.clear_quote = self.clear_quote
+        self.main_engine.clear_all_quotes = self.clear_all_quotes
+
+    def set_throttle(self, gateway_name: str, rate: float, burst: float) -> None:
+        """
+        Set request rate limit of gateway.
+        """
+        self.buckets[gateway_name] = TokenBucket(rate, burst, self.event_engine.get_clock().monotonic())
+
+    def set_quote(
+        self,
+        vt_symbol: str,
+        bid_price: float,
+        bid_volume: int,
+        ask_price: float,
+        ask_volume: int,
+        bid_offset: Offset = Offset.NONE,
+        ask_offset: Offset = Offset.NONE,
+        reference: str = ""
+    ) -> bool:
+        """
+        Set desired quote of vt_symbol, prices are rounded to pricetick.
+        """
+        slot: Optional[QuoteSlot] = self.get_slot(vt_symbol)
+        if not slot:
+            return False
+
+        pricetick: float = slot.contract.pricetick
+        symbol, exchange = extract_vt_symbol(vt_symbol)
+
+        slot.target = QuoteRequest(
+            symbol=symbol,
+            exchange=exchange,
+            bid_price=round_to(bid_price, pricetick),
+            bid_volume=bid_volume,
+            ask_price=round_to(ask_price, pricetick),
+            ask_volume=ask_volume,
+            bid_offset=bid_offset,
+            ask_offset=ask_offset,
+            reference=reference
+        )
+
+        self.mark_dirty(vt_symbol)
+        return True
+
+    def clear_quote(self, vt_symbol: str) -> None:
+        """
+        Clear desired quote of vt_symbol, so live quote is cancelled.
+        """
+        slot: Optional[QuoteSlot] = self.slots.get(vt_symbol, None)
+        if slot and slot.target:
+            slot.target = None
+            self.mark_dirty(vt_symbol)
+
+    def clear_all_quotes(self) -> None:
+        """"""
+        for vt_symbol in self.slots.keys():
+            self.clear_quote(vt_symbol)
+
+    def get_slot(self, vt_symbol: str) -> Optional[QuoteSlot]:
+        """"""
+        slot: Optional[QuoteSlot] = self.slots.get(vt_symbol, None)
+        if slot:
+            return slot
+
+        contract: Optional[ContractData] = self.main_engine.get_contract(vt_symbol)
+        if not contract:
+            self.main_engine.write_log(_("报价失败，找不到合约：{}").format(vt_symbol), "QUOTE")
+            return None
+
+        slot = QuoteSlot(contract)
+        self.slots[vt_symbol] = slot
+        return slot
+
+    def mark_dirty(self, vt_symbol: str) -> None:
+        """
+        Mark symbol to be reconciled, and queue flush event if none
+        pending.
+        """
+        self.dirty_symbols[vt_symbol] = None
+
+        if not self.flush_pending:
+            self.flush_pending = True
+            self.event_engine.put(Event(EVENT_QUOTE_FLUSH))
+
+    def process_flush_event(self, event: Event) -> None:
+        """"""
+        self.flush_pending = False
+        self.flush()
+
+    def process_timer_event(self, event: Event) -> None:
+        """
+        Check requests timed out and retry symbols throttled in last flush.
+        """
+        self.check_timeout()
+
+        if self.dirty_symbols and not self.flush_pending:
+            self.flush()
+
+    def check_timeout(self) -> None:
+        """
+        Reset slots whose request got no response within timeout.
+
+        Quote stuck in submitting is cancelled, and cancel stuck is sent
+        again. Quote never acknowledged is dropped if its cancel also
+        timed out, as it may not exist in gateway at all.
+        """
+        now: float = self.event_engine.get_clock().monotonic()
+
+        for vt_symbol, slot in self.slots.items():
+            quote: Optional[QuoteData] = slot.quote
+            if not quote or now - slot.request_time < self.request_timeout:
+                continue
+
+            if slot.cancelling and quote.status == Status.SUBMITTING:
+                self.quote_symbols.pop(quote.vt_quoteid, None)
+                slot.quote = None
+                slot.cancelling = False
+                self.mark_dirty(vt_symbol)
+
+                self.main_engine.write_log(_("报价请求超时，放弃报价：{}").format(quote.vt_quoteid), "QUOTE")
+            elif slot.cancelling:
+                slot.cancelling = False
+                self.mark_dirty(vt_symbol)
+
+                self.main_engine.write_log(_("撤销报价超时，重新撤销：{}").format(quote.vt_quoteid), "QUOTE")
+            elif quote.status == Status.SUBMITTING:
+                self.cancel_quote(slot, now)
+
+                self.main_engine.write_log(_("报价请求超时，撤销报价：{}").format(quote.vt_quoteid), "QUOTE")
+
+    def cancel_quote(self, slot: QuoteSlot, now: float) -> None:
+        """"""
+        quote: QuoteData = slot.quote
+        req: CancelRequest = quote.create_cancel_request()
+        self.main_engine.cancel_quote(req, quote.gateway_name)
+
+        slot.cancelling = True
+        slot.request_time = now
+        self.cancel_count += 1
+
+    def flush(self) -> None:
+        """
+        Reconcile all dirty symbols, cancels before new quotes.
+        """
+        dirty_symbols: Dict[str, None] = self.dirty_symbols
+        self.dirty_symbols = {}
+
+        sends: list = []
+        throttled: set = set()
+        now: float = self.event_engine.get_clock().monotonic()
+
+        for vt_symbol in dirty_symbols:
+            slot: QuoteSlot = self.slots[vt_symbol]
+            quote: Optional[QuoteData] = slot.quote
+
+            if quote:
+                # Wait for result of request in flight
+                if slot.cancelling or quote.status == Status.SUBMITTING:
+                    continue
+
+                if slot.target and slot.is_matched():
+                    continue
+
+                if not self.consume_token(slot, now, throttled):
+                    self.dirty_symbols[vt_symbol] = None
+                    continue
+
+                self.cancel_quote(slot, now)
+            elif slot.target:
+                sends.append(slot)
+
+        for slot in sends:
+            vt_symbol = slot.contract.vt_symbol
+
+            if not self.consume_token(slot, now, throttled):
+                self.dirty_symbols[vt_symbol] = None
+                continue
+
+            gateway_name: str = slot.contract.gateway_name
+            vt_quoteid: str = self.main_engine.send_quote(slot.target, gateway_name)
+            if not vt_quoteid:
+                continue
+
+            slot.quote = slot.target.create_quote_data(vt_quoteid.split(".", 1)[1], gateway_name)
+            slot.request_time = now
+            self.quote_symbols[vt_quoteid] = vt_symbol
+            self.send_count += 1
+
+    def consume_token(self, slot: QuoteSlot, now: float, throttled: set) -> bool:
+        """
+        Take token of gateway, gateways throttled are not checked again
+        in the same flush.
+        """
+        gateway_name: str = slot.contract.gateway_name
+        if gateway_name in throttled:
+            return False
+
+        bucket: Optional[TokenBucket] = self.buckets.get(gateway_name, None)
+        if not bucket:
+            bucket = TokenBucket(self.default_rate, self.default_burst, now)
+            self.buckets[gateway_name] = bucket
+
+        if bucket.consume(now):
+            return True
+
+        self.throttle_count += 1
+        throttled.add(gateway_name)
+        return False
+
+    def process_quote_event(self, event: Event) -> None:
+        """"""
+        quote: QuoteData = event.data
+
+        vt_symbol: Optional[str] = self.quote_symbols.get(quote.vt_quoteid, None)
+        if not vt_symbol:
+            return
+
+        slot: QuoteSlot = self.slots[vt_symbol]
+
+        # Ignore late update of previous quote
+        if not slot.quote or slot.quote.vt_quoteid != quote.vt_quoteid:
+            return
+
+        if quote.is_active():
+            slot.quote = quote
+
+            # Target may have changed while quote was submitting
+            if not slot.cancelling:
+                self.mark_dirty(vt_symbol)
+            return
+
+        self.quote_symbols.pop(quote.vt_quoteid)
+        slot.quote = None
+        slot.cancelling = False
+
+        # Stop quoting rejected symbol to avoid rejection loop
+        if quote.status == Status.REJECTED:
+            slot.target = None
+            self.main_engine.write_log(_("报价被拒单，停止报价：{}").format(vt_symbol), "QUOTE")
+
+        self.mark_dirty(vt_symbol)
@@ -0,0 +1,360 @@
+"""
+Deterministic replay of recorded events through trading engines.
+"""
+
+from collections import deque
+from copy import copy
+from datetime import datetime
+from pathlib import Path
+from time import perf_counter_ns
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+from vnpy.event import Event, EventEngine, EVENT_TIMER, BaseClock, VirtualClock, get_clock, set_clock
+from vnpy.event.journal import JournalReader
+
+from .constant import Direction, Exchange, Status
+from .engine import BaseEngine, MainEngine
+from .event import (
+    EVENT_TICK,
+    EVENT_ORDER,
+    EVENT_TRADE,
+    EVENT_POSITION,
+    EVENT_ACCOUNT,
+    EVENT_CONTRACT,
+    EVENT_QUOTE,
+    EVENT_CONTRACTS,
+    EVENT_POSITIONS
+)
+from .gateway import BaseGateway
+from .object import (
+    TickData,
+    OrderData,
+    TradeData,
+    OrderRequest,
+    CancelRequest,
+    SubscribeRequest,
+    HistoryRequest,
+    BarData
+)
+
+
+# Gateway callback used to push recorded data of each event type
+CALLBACK_NAMES: Dict[str, str] = {
+    EVENT_TICK: "on_tick",
+    EVENT_ORDER: "on_order",
+    EVENT_TRADE: "on_trade",
+    EVENT_POSITION: "on_position",
+    EVENT_ACCOUNT: "on_account",
+    EVENT_CONTRACT: "on_contract",
+    EVENT_QUOTE: "on_quote",
+    EVENT_CONTRACTS: "on_contracts",
+    EVENT_POSITIONS: "on_positions",
+}
+
+
+class ReplayEventEngine(EventEngine):
+    """
+    Event engine without any thread for replay.
+
+    Events are processed synchronously when the queue is drained by
+    replay engine, and timer events are generated from a virtual clock
+    driven by the time of recorded events. The virtual clock is also
+    set as global clock between start and stop, so that timestamps
+    generated by other components during replay follow recorded time.
+    """
+
+    timer_catchup: int = 3          # Max timer events generated for a gap of records
+
+    def __init__(self, interval: int = 1) -> None:
+        """"""
+        self.clock: VirtualClock = VirtualClock()
+
+        super().__init__(interval, self.clock)
+
+        self._events: deque = deque()
+        self._timer_time: float = 0
+        self._previous_clock: Optional[BaseClock] = None
+
+    def start(self) -> None:
+        """
+        No thread is started in replay mode, virtual clock replaces
+        global clock until stopped.
+        """
+        if self._active:
+            return
+        self._active = True
+
+        self._previous_clock = get_clock()
+        set_clock(self.clock)
+
+    def stop(self) -> None:
+        """
+        Restore global clock replaced on start.
+        """
+        if not self._active:
+            return
+        self._active = False
+
+        if get_clock() is self.clock:
+            set_clock(self._previous_clock)
+        self._previous_clock = None
+
+    def put(self, event: Event) -> None:
+        """
+        Put an event object into event queue.
+        """
+        self._events.append(event)
+
+    def drain(self) -> int:
+        """
+        Process all events in queue, including those put by handlers.
+        """
+        count: int = 0
+        events: deque = self._events
+
+        while events:
+            self._process(events.popleft())
+            count += 1
+
+        return count
+
+    def update_time(self, now_ns: int) -> None:
+        """
+        Advance virtual clock and generate timer events for every
+        interval passed.
+
+        Records without timestamp are ignored, and timer events missed
+        by a long gap between records are skipped except the last few.
+        """
+        if now_ns <= 0:
+            return
+
+        self.clock.set_time(now_ns / 1_000_000_000)
+        now: float = self.clock.time()
+
+        if not self._timer_time:
+            self._timer_time = now + self._interval
+            return
+
+        if now < self._timer_time:
+            return
+
+        missed: int = int((now - self._timer_time) // self._interval) + 1
+        if missed > self.timer_catchup:
+            self._timer_time += (missed - self.timer_catchup) * self._interval
+
+        while now >= self._timer_time:
+            self.put(Event(EVENT_TIMER))
+            self.drain()
+            self._timer_time += self._interval
+
+
+class ReplayGateway(BaseGateway):
+    """
+    Gateway pushing recorded data during replay.
+
+    Orders sent by strategies are accepted immediately, and filled when
+    a later tick of the same symbol crosses the limit price.
+    """
+
+    default_name: str = "REPLAY"
+
+    default_setting: Dict[str, str] = {}
+
+    exchanges: List[Exchange] = list(Exchange)
+
+    def __init__(self, event_engine: EventEngine, gateway_name: str) -> None:
+        """"""
+        super().__init__(event_engine, gateway_name)
+
+        self.order_count: int = 0
+        self.trade_count: int = 0
+
+        self.active_orders: Dict[str, OrderData] = {}
+        self.datetime: Optional[datetime] = None
+
+    def on_tick(self, tick: TickData) -> None:
+        """
+        Cross active orders with new tick before pushing it.
+        """
+        self.datetime = tick.datetime
+        self.cross_order(tick)
+
+        super().on_tick(tick)
+
+    def cross_order(self, tick: TickData) -> None:
+        """
+        Fill active orders whose price crossed by tick.
+        """
+        for order in list(self.active_orders.values()):
+            if order.vt_symbol != tick.vt_symbol:
+                continue
+
+            if order.direction == Direction.LONG:
+                if not tick.ask_price_1 or order.price < tick.ask_price_1:
+                    continue
+                price: float = min(order.price, tick.ask_price_1)
+            else:
+                if not tick.bid_price_1 or order.price > tick.bid_price_1:
+                    continue
+                price: float = max(order.price, tick.bid_price_1)
+
+            self.trade_count += 1
+
+            trade: TradeData = TradeData(
+                symbol=order.symbol,
+                exchange=order.exchange,
+                orderid=order.orderid,
+                tradeid=f"replay{self.trade_count}",
+                direction=order.direction,
+                offset=order.offset,
+                price=price,
+                volume=order.volume - order.traded,
+                datetime=tick.datetime,
+                gateway_name=self.gateway_name
+            )
+
+            order.traded = order.volume
+            order.status = Status.ALLTRADED
+            self.active_orders.pop(order.vt_orderid)
+
+            self.on_order(copy(order))
+            self.on_trade(trade)
+
+    def connect(self, setting: dict) -> None:
+        """"""
+        pass
+
+    def close(self) -> None:
+        """"""
+        pass
+
+    def subscribe(self, req: SubscribeRequest) -> None:
+        """"""
+        pass
+
+    def send_order(self, req: OrderRequest) -> str:
+        """"""
+        self.order_count += 1
+
+        order: OrderData = req.create_order_data(f"replay{self.order_count}", self.gateway_name)
+        order.status = Status.NOTTRADED
+        order.datetime = self.datetime
+
+        self.active_orders[order.vt_orderid] = order
+        self.on_order(copy(order))
+
+        return order.vt_orderid
+
+    def cancel_order(self, req: CancelRequest) -> None:
+        """"""
+        vt_orderid: str = f"{self.gateway_name}.{req.orderid}"
+        order: Optional[OrderData] = self.active_orders.pop(vt_orderid, None)
+        if not order:
+            return
+
+        order.status = Status.CANCELLED
+        self.on_order(copy(order))
+
+    def query_account(self) -> None:
+        """"""
+        pass
+
+    def query_position(self) -> None:
+        """"""
+        pass
+
+    def query_history(self, req: HistoryRequest) -> List[BarData]:
+        """"""
+        return []
+
+
+class ReplayEngine(BaseEngine):
+    """
+    Replays recorded events through main engine as fast as possible.
+
+    Main engine must be created with a ReplayEventEngine, so that each
+    recorded event together with all events generated by handlers
+    is processed completely before the next one.
+    """
+
+    def __init__(self, main_engine: MainEngine, event_engine: ReplayEventEngine) -> None:
+        """"""
+        super().__init__(main_engine, event_engine, "replay")
+
+        self.gateways: Dict[str, ReplayGateway] = {}
+
+    def get_gateway(self, gateway_name: str) -> ReplayGateway:
+        """
+        Get replay gateway with recorded name, create it if not exists.
+        """
+        gateway: Optional[ReplayGateway] = self.gateways.get(gateway_name, None)
+
+        if not gateway:
+            gateway = self.main_engine.add_gateway(ReplayGateway, gateway_name)
+            self.gateways[gateway_name] = gateway
+
+        return gateway
+
+    def replay_journal(self, path: Path, types: Set[str] = None) -> dict:
+        """
+        Replay events recorded in an event journal file.
+        """
+        with JournalReader(path) as reader:
+            records: Iterable[Tuple[int, Event]] = (
+                (enqueue_ns, event) for enqueue_ns, _dispatch_ns, event in reader
+            )
+            return self.replay(records, types)
+
+    def replay(self, records: Iterable[Tuple[int, Event]], types: Set[str] = None) -> dict:
+        """
+        Replay recorded (timestamp ns, event) pairs in order.
+
+        Only event types with gateway callback are replayed, by default
+        all of them. Return statistics of the replay.
+        """
+        if not types:
+            types = set(CALLBACK_NAMES.keys())
+
+        count: int = 0
+        processed: int = 0
+        max_ns: int = 0
+
+        start_ns: int = perf_counter_ns()
+
+        for timestamp, event in records:
+            if event.type not in types:
+                continue
+
+            data = event.data
+
+            # Batch event data is a list of objects from same gateway
+            if isinstance(data, list):
+                if not data:
+                    continue
+                gateway_name: str = data[0].gateway_name
+            else:
+                gateway_name = data.gateway_name
+
+            gateway: ReplayGateway = self.get_gateway(gateway_name)
+            callback = getattr(gateway, CALLBACK_NAMES[event.type])
+
+            record_start: int = perf_counter_ns()
+
+            self.event_engine.update_time(timestamp)
+            callback(data)
+            processed += self.event_engine.drain()
+
+            cost: int = perf_counter_ns() - record_start
+            max_ns = max(max_ns, cost)
+            count += 1
+
+        total_ns: int = perf_counter_ns() - start_ns
+
+        return {
+            "records": count,
+            "events": processed,
+            "seconds": total_ns / 1e9,
+            "mean_us": total_ns / count / 1000 if count else 0,
+            "max_us": max_ns / 1000
+        }
@@ -17,14 +17,25 @@ SETTINGS: Dict[str, Any] = {
     "log.level": CRITICAL,
     "log.console": True,
     "log.file": True,
+    "log.fsync": False,
 
     "email.server": "smtp.qq.com",
     "email.port": 465,
+    "email.ssl": True,
     "email.username": "",
     "email.password": "",
     "email.sender": "",
     "email.receiver": "",
 
+    "contract.cache": False,
+
+    "journal.active": False,
+
+    "trace.active": False,
+
+    "profile.active": False,
+    "profile.memory": False,
+
     "datafeed.name": "",
     "datafeed.username": "",
     "datafeed.password": "",
@@ -0,0 +1,327 @@
+"""
+Synthetic spread market data calculated from leg ticks.
+"""
+
+from datetime import datetime
+from typing import Dict, List, Optional, Set, Tuple
+
+from vnpy.event import Event, EventEngine
+
+from .constant import Exchange
+from .engine import BaseEngine, MainEngine
+from .event import EVENT_TICK, EVENT_SPREAD_CALC
+from .object import ContractData, SubscribeRequest, TickData
+from .locale import _
+
+
+SPREAD_GATEWAY: str = "SPREAD"
+SPREAD_DEPTH: int = 5
+
+Book = List[Tuple[float, float]]
+
+
+class SpreadLeg:
+    """
+    Leg of spread with price and volume ratio.
+
+    Spread price is the sum of leg prices times price multiplier, and
+    one unit of spread requires absolute trading multiplier of leg
+    volume. Leg is bought when spread is bought if multiplier positive.
+    """
+
+    def __init__(self, vt_symbol: str, price_multiplier: float, trading_multiplier: float) -> None:
+        """"""
+        self.vt_symbol: str = vt_symbol
+        self.price_multiplier: float = price_multiplier
+        self.trading_multiplier: float = trading_multiplier
+        self.volume_ratio: float = abs(trading_multiplier)
+
+        self.tick: Optional[TickData] = None
+        self.bids: Book = []
+        self.asks: Book = []
+
+    def update_tick(self, tick: TickData) -> None:
+        """
+        Cache depth of tick as price level lists, shared by all spreads
+        containing the leg.
+        """
+        self.tick = tick
+
+        self.bids = [
+            (price, volume) for price, volume in (
+                (tick.bid_price_1, tick.bid_volume_1),
+                (tick.bid_price_2, tick.bid_volume_2),
+                (tick.bid_price_3, tick.bid_volume_3),
+                (tick.bid_price_4, tick.bid_volume_4),
+                (tick.bid_price_5, tick.bid_volume_5),
+            ) if volume > 0
+        ]
+
+        self.asks = [
+            (price, volume) for price, volume in (
+                (tick.ask_price_1, tick.ask_volume_1),
+                (tick.ask_price_2, tick.ask_volume_2),
+                (tick.ask_price_3, tick.ask_volume_3),
+                (tick.ask_price_4, tick.ask_volume_4),
+                (tick.ask_price_5, tick.ask_volume_5),
+            ) if volume > 0
+        ]
+
+
+class SpreadData:
+    """
+    Spread of legs whose book is rebuilt when any leg tick changed.
+    """
+
+    def __init__(self, name: str, legs: List[SpreadLeg]) -> None:
+        """"""
+        self.name: str = name
+        self.legs: List[SpreadLeg] = legs
+        self.vt_symbol: str = f"{name}.{Exchange.LOCAL.value}"
+
+        self.tick: Optional[TickData] = None
+
+    def calculate(self) -> Optional[TickData]:
+        """
+        Calculate spread tick from cached leg depth, None if any leg
+        has not received tick yet.
+        """
+        dt: Optional[datetime] = None
+        last_price: float = 0
+
+        for leg in self.legs:
+            if not leg.tick:
+                return None
+
+            last_price += leg.tick.last_price * leg.price_multiplier
+            if not dt or leg.tick.datetime > dt:
+                dt = leg.tick.datetime
+
+        # Spread is sold on bid side: sell positive legs and buy negative legs
+        bid_books: List[Book] = [leg.bids if leg.price_multiplier > 0 else leg.asks for leg in self.legs]
+        ask_books: List[Book] = [leg.asks if leg.price_multiplier > 0 else leg.bids for leg in self.legs]
+
+        bids: Book = synthesize_book(self.legs, bid_books)
+        asks: Book = synthesize_book(self.legs, ask_books)
+
+        tick: TickData = TickData(
+            symbol=self.name,
+            exchange=Exchange.LOCAL,
+            datetime=dt,
+            name=self.name,
+            last_price=last_price,
+            localtime=datetime.now(),
+            gateway_name=SPREAD_GATEWAY
+        )
+
+        for n, (price, volume) in enumerate(bids, 1):
+            setattr(tick, f"bid_price_{n}", price)
+            setattr(tick, f"bid_volume_{n}", volume)
+
+        for n, (price, volume) in enumerate(asks, 1):
+            setattr(tick, f"ask_price_{n}", price)
+            setattr(tick, f"ask_volume_{n}", volume)
+
+        self.tick = tick
+        return tick
+
+
+def synthesize_book(legs: List[SpreadLeg], books: List[Book]) -> Book:
+    """
+    Build spread price levels by sweeping leg books together.
+
+    Each spread level takes the largest volume available at current
+    level of every leg, then legs whose level is used up move to next
+    level. Spread volume may be fractional if leg volume is not exact
+    multiple of trading multiplier.
+    """
+    if not all(books):
+        return []
+
+    indexes: List[int] = [0] * len(books)
+    remains: List[float] = [book[0][1] for book in books]
+    levels: Book = []
+
+    while True:
+        price: float = 0
+        volume: float = float("inf")
+
+        for leg, book, ix, remain in zip(legs, books, indexes, remains):
+            price += book[ix][0] * leg.price_multiplier
+            volume = min(volume, remain / leg.volume_ratio)
+
+        if levels and levels[-1][0] == price:
+            levels[-1] = (price, levels[-1][1] + volume)
+        elif len(levels) < SPREAD_DEPTH:
+            levels.append((price, volume))
+        else:
+            break
+
+        exhausted: bool = False
+        for i, leg in enumerate(legs):
+            remains[i] -= volume * leg.volume_ratio
+
+            if remains[i] <= 1e-9:
+                indexes[i] += 1
+                if indexes[i] == len(books[i]):
+                    exhausted = True
+                else:
+                    remains[i] = books[i][indexes[i]][1]
+
+        if exhausted:
+            break
+
+    return levels
+
+
+class SpreadEngine(BaseEngine):
+    """
+    Publishes synthetic spread ticks calculated from leg ticks.
+
+    Leg depth is parsed once per leg tick and shared by all spreads
+    containing the leg. Spreads affected are only marked dirty, and
+    recalculated together on a calc event queued after the leg ticks,
+    so a burst of leg ticks costs one calculation of each spread.
+    """
+
+    def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
+        """"""
+        super().__init__(main_engine, event_engine, "spread")
+
+        self.spreads: Dict[str, SpreadData] = {}
+        self.legs: Dict[str, SpreadLeg] = {}
+        self.leg_spreads: Dict[str, Set[str]] = {}
+
+        self.dirty_spreads: Set[str] = set()
+
+        self.event_engine.register(EVENT_SPREAD_CALC, self.process_calc_event)
+
+        self.main_engine.add_spread = self.add_spread
+        self.main_engine.remove_spread = self.remove_spread
+        self.main_engine.get_spread_tick = self.get_spread_tick
+
+    def add_spread(self, name: str, legs: List[Tuple[str, float, float]]) -> bool:
+        """
+        Add spread with list of (vt_symbol, price multiplier, trading
+        multiplier) of each leg.
+        """
+        if name in self.spreads:
+            self.main_engine.write_log(_("价差{}已存在").format(name), "SPREAD")
+            return False
+
+        if not legs:
+            return False
+
+        spread_legs: List[SpreadLeg] = []
+
+        for vt_symbol, price_multiplier, trading_multiplier in legs:
+            if not trading_multiplier:
+                self.main_engine.write_log(_("价差{}的腿{}交易乘数不能为0").format(name, vt_symbol), "SPREAD")
+                return False
+
+            # Spreads with same leg symbol and ratios share leg object
+            key: str = f"{vt_symbol}:{price_multiplier}:{trading_multiplier}"
+            leg: Optional[SpreadLeg] = self.legs.get(key, None)
+            if not leg:
+                leg = SpreadLeg(vt_symbol, price_multiplier, trading_multiplier)
+                self.legs[key] = leg
+
+                tick: Optional[TickData] = self.main_engine.get_tick(vt_symbol)
+                if tick:
+                    leg.update_tick(tick)
+
+            spread_legs.append(leg)
+
+        spread: SpreadData = SpreadData(name, spread_legs)
+        self.spreads[name] = spread
+
+        for leg in spread_legs:
+            if leg.vt_symbol not in self.leg_spreads:
+                self.leg_spreads[leg.vt_symbol] = set()
+                self.event_engine.register(EVENT_TICK + leg.vt_symbol, self.process_leg_tick_event)
+                self.subscribe(leg.vt_symbol)
+
+            self.leg_spreads[leg.vt_symbol].add(name)
+
+        self.mark_dirty([name])
+        return True
+
+    def remove_spread(self, name: str) -> bool:
+        """"""
+        spread: Optional[SpreadData] = self.spreads.pop(name, None)
+        if not spread:
+            return False
+
+        self.dirty_spreads.discard(name)
+
+        for leg in spread.legs:
+            names: Set[str] = self.leg_spreads.get(leg.vt_symbol, set())
+            names.discard(name)
+
+            if not names and leg.vt_symbol in self.leg_spreads:
+                self.leg_spreads.pop(leg.vt_symbol)
+                self.event_engine.unregister(EVENT_TICK + leg.vt_symbol, self.process_leg_tick_event)
+
+        # Remove leg objects no longer used by any spread
+        used: Set[int] = {id(leg) for spread in self.spreads.values() for leg in spread.legs}
+        for key, leg in list(self.legs.items()):
+            if id(leg) not in used:
+                self.legs.pop(key)
+
+        return True
+
+    def get_spread_tick(self, name: str) -> Optional[TickData]:
+        """"""
+        spread: Optional[SpreadData] = self.spreads.get(name, None)
+        if spread:
+            return spread.tick
+        return None
+
+    def subscribe(self, vt_symbol: str) -> None:
+        """"""
+        contract: Optional[ContractData] = self.main_engine.get_contract(vt_symbol)
+        if not contract:
+            return
+
+        req: SubscribeRequest = SubscribeRequest(contract.symbol, contract.exchange)
+        self.main_engine.subscribe(req, contract.gateway_name)
+
+    def process_leg_tick_event(self, event: Event) -> None:
+        """"""
+        tick: TickData = event.data
+
+        names: Set[str] = self.leg_spreads.get(tick.vt_symbol, None)
+        if not names:
+            return
+
+        for name in names:
+            for leg in self.spreads[name].legs:
+                if leg.vt_symbol == tick.vt_symbol and leg.tick is not tick:
+                    leg.update_tick(tick)
+
+        self.mark_dirty(names)
+
+    def mark_dirty(self, names: Set[str]) -> None:
+        """
+        Mark spreads to be calculated, and queue calc event if none
+        pending.
+        """
+        if not self.dirty_spreads:
+            self.event_engine.put(Event(EVENT_SPREAD_CALC))
+
+        self.dirty_spreads.update(names)
+
+    def process_calc_event(self, event: Event) -> None:
+        """"""
+        names: Set[str] = self.dirty_spreads
+        self.dirty_spreads = set()
+
+        for name in names:
+            spread: Optional[SpreadData] = self.spreads.get(name, None)
+            if not spread:
+                continue
+
+            tick: Optional[TickData] = spread.calculate()
+            if tick:
+                self.event_engine.put(Event(EVENT_TICK, tick))
+                self.event_engine.put(Event(EVENT_TICK + tick.vt_symbol, tick))
@@ -0,0 +1,87 @@
+"""
+Price-sorted index of local stop orders.
+"""
+
+from bisect import bisect_left, bisect_right, insort
+from typing import Dict, List, Tuple
+
+from .constant import Direction
+
+
+class StopOrderBook:
+    """
+    Waiting stop orders of one symbol sorted by stop price.
+
+    Buy stops are triggered when price rises to stop price and sell stops
+    when price falls to it, so on each price update only a prefix of buy
+    stops and a suffix of sell stops need to be checked, found with
+    binary search. Orders with same stop price are triggered by the
+    sequence they were added.
+    """
+
+    def __init__(self) -> None:
+        """"""
+        self.buy_stops: List[Tuple[float, int, str]] = []
+        self.sell_stops: List[Tuple[float, int, str]] = []
+
+        self.keys: Dict[str, Tuple[Direction, float, int]] = {}
+        self.count: int = 0
+
+    def __len__(self) -> int:
+        """"""
+        return len(self.keys)
+
+    def add(self, stop_orderid: str, direction: Direction, price: float) -> None:
+        """
+        Add stop order into book.
+        """
+        self.count += 1
+        self.keys[stop_orderid] = (direction, price, self.count)
+
+        if direction == Direction.LONG:
+            insort(self.buy_stops, (price, self.count, stop_orderid))
+        else:
+            insort(self.sell_stops, (price, self.count, stop_orderid))
+
+    def remove(self, stop_orderid: str) -> bool:
+        """
+        Remove stop order from book, return False if not found.
+        """
+        key: tuple = self.keys.pop(stop_orderid, None)
+        if not key:
+            return False
+
+        direction, price, count = key
+
+        if direction == Direction.LONG:
+            stops: list = self.buy_stops
+        else:
+            stops = self.sell_stops
+
+        ix: int = bisect_left(stops, (price, count))
+        del stops[ix]
+
+        return True
+
+    def match(self, price: float) -> List[str]:
+        """
+        Remove and return stop orders triggered by price.
+        """
+        triggered: List[str] = []
+
+        # Buy stops with stop price not above price
+        ix: int = bisect_right(self.buy_stops, (price, float("inf")))
+        if ix:
+            triggered.extend(stop[2] for stop in self.buy_stops[:ix])
+            del self.buy_stops[:ix]
+
+        # Sell stops with stop price not below price
+        ix = bisect_left(self.sell_stops, (price,))
+        if ix < len(self.sell_stops):
+            triggered.extend(stop[2] for stop in self.sell_stops[ix:])
+            del self.sell_stops[ix:]
+
+        for stop_orderid in triggered:
+            self.keys.pop(stop_orderid)
+
+        return triggered
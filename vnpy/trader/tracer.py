@@ -0,0 +1,326 @@
+"""
+Latency tracing from tick receiving to order sending.
+"""
+
+from collections import defaultdict, deque
+from threading import local
+from time import perf_counter_ns, time
+from typing import Any, Callable, Dict, Optional, Tuple
+
+from vnpy.event import Event, EventEngine
+
+from .event import EVENT_TICK
+from .gateway import BaseGateway
+from .object import OrderRequest, TickData
+
+
+class LatencyHistogram:
+    """
+    Histogram of latency in nanoseconds with power of 2 buckets.
+    """
+
+    def __init__(self) -> None:
+        """"""
+        self.buckets: list = [0] * 64
+        self.count: int = 0
+        self.total: int = 0
+        self.max: int = 0
+
+    def add(self, ns: int) -> None:
+        """
+        Add one latency sample.
+        """
+        if ns < 0:
+            ns = 0
+
+        self.buckets[ns.bit_length()] += 1
+        self.count += 1
+        self.total += ns
+
+        if ns > self.max:
+            self.max = ns
+
+    def get_percentile(self, percent: float) -> int:
+        """
+        Get upper bound of bucket at percentile.
+        """
+        if not self.count:
+            return 0
+
+        target: float = self.count * percent / 100
+        accumulated: int = 0
+
+        for i, n in enumerate(self.buckets):
+            accumulated += n
+            if accumulated >= target:
+                return min((1 << i) - 1, self.max)
+
+        return self.max
+
+    def get_summary(self) -> dict:
+        """
+        Get statistics in microseconds.
+        """
+        return {
+            "count": self.count,
+            "mean_us": self.total / self.count / 1000 if self.count else 0,
+            "p50_us": self.get_percentile(50) / 1000,
+            "p99_us": self.get_percentile(99) / 1000,
+            "max_us": self.max / 1000,
+        }
+
+
+class LatencyTracer:
+    """
+    Trace latency of events and orders through trading engines.
+
+    Stages recorded for every order sent while a tick event is being
+    dispatched, with tick as cause of order:
+        * receive: tick localtime to on_tick of gateway called
+        * queue: put into event queue to dispatch start
+        * handler: dispatch start to send_order called by the handler
+        * send: send_order of main engine until gateway returns
+        * total: on_tick of gateway (or put into queue for ticks not
+          pushed by gateway, e.g. in replay) until send_order returns
+
+    Stage histograms are kept per reference (strategy) and gateway.
+    Individual handlers are not stamped, as they are called inside the
+    dispatch function of event engine. Instead time cost of dispatching
+    each event type to all of its handlers is recorded. Ticks of both
+    EVENT_TICK and EVENT_TICK + vt_symbol are traced.
+
+    Hooks are chained to functions saved on start, so the tracer can be
+    stacked with other hooks such as event journal.
+    """
+
+    link_limit: int = 10000             # Max number of order links kept
+
+    def __init__(self, main_engine: Any, event_engine: EventEngine) -> None:
+        """"""
+        self.main_engine: Any = main_engine
+        self.event_engine: EventEngine = event_engine
+
+        self.histograms: Dict[Tuple[str, str, str], LatencyHistogram] = defaultdict(LatencyHistogram)
+        self.event_histograms: Dict[str, LatencyHistogram] = defaultdict(LatencyHistogram)
+
+        self.links: Dict[str, Tuple[str, int]] = {}
+        self.link_queue: deque = deque()
+
+        self.context: local = local()
+        self.gateway_context: local = local()
+
+        self.active: bool = False
+        self.engine_put: Callable = None
+        self.engine_process: Callable = None
+        self.main_send_order: Callable = None
+        self.main_add_gateway: Callable = None
+
+        # Saved and hooked on_tick functions of gateways
+        self.gateway_hooks: Dict[str, Tuple[Callable, Callable]] = {}
+
+    def start(self) -> None:
+        """
+        Hook functions of event engine and main engine.
+        """
+        # Hooks kept in chain after close are reused
+        if self.engine_put:
+            self.active = True
+            return
+
+        self.engine_put = self.event_engine.put
+        self.engine_process = self.event_engine._process
+        self.main_send_order = self.main_engine.send_order
+        self.main_add_gateway = self.main_engine.add_gateway
+
+        self.event_engine.put = self.put
+        self.event_engine._process = self.process
+        self.main_engine.send_order = self.send_order
+        self.main_engine.add_gateway = self.add_gateway
+
+        for gateway in self.main_engine.gateways.values():
+            self.hook_gateway(gateway)
+
+        self.active = True
+
+    def close(self) -> None:
+        """
+        Restore hooked functions.
+
+        If other hooks were added on top of tracer, functions are not
+        restored to keep their chain intact, and tracer only passes
+        calls through afterwards.
+        """
+        if not self.active:
+            return
+        self.active = False
+
+        if (
+            self.event_engine.put != self.put
+            or self.event_engine._process != self.process
+            or self.main_engine.send_order != self.send_order
+            or self.main_engine.add_gateway != self.add_gateway
+        ):
+            return
+
+        self.event_engine.put = self.engine_put
+        self.event_engine._process = self.engine_process
+        self.main_engine.send_order = self.main_send_order
+        self.main_engine.add_gateway = self.main_add_gateway
+
+        for gateway_name, (gateway_on_tick, on_tick) in self.gateway_hooks.items():
+            gateway: BaseGateway = self.main_engine.gateways.get(gateway_name, None)
+            if gateway and gateway.on_tick is on_tick:
+                gateway.on_tick = gateway_on_tick
+        self.gateway_hooks.clear()
+
+        self.engine_put = None
+
+    def add_gateway(self, *args, **kwargs) -> BaseGateway:
+        """
+        Hook on_tick of gateway added after tracer started.
+        """
+        gateway: BaseGateway = self.main_add_gateway(*args, **kwargs)
+        self.hook_gateway(gateway)
+        return gateway
+
+    def hook_gateway(self, gateway: BaseGateway) -> None:
+        """
+        Replace on_tick of gateway with function stamping tick received.
+        """
+        if gateway.gateway_name in self.gateway_hooks:
+            return
+
+        gateway_on_tick: Callable = gateway.on_tick
+
+        def on_tick(tick: TickData) -> None:
+            """"""
+            self.on_tick(tick, gateway_on_tick)
+
+        gateway.on_tick = on_tick
+        self.gateway_hooks[gateway.gateway_name] = (gateway_on_tick, on_tick)
+
+    def on_tick(self, tick: TickData, gateway_on_tick: Callable) -> None:
+        """
+        Stamp tick received by gateway, which is kept in context of the
+        gateway thread while its events are put into queue.
+        """
+        if not self.active:
+            gateway_on_tick(tick)
+            return
+
+        context: local = self.gateway_context
+        context.tick = tick
+        context.receive_ns = perf_counter_ns()
+
+        if tick.localtime:
+            receive_ns: int = int((time() - tick.localtime.timestamp()) * 1_000_000_000)
+            self.histograms[("receive", "", tick.gateway_name)].add(receive_ns)
+
+        try:
+            gateway_on_tick(tick)
+        finally:
+            context.tick = None
+
+    def put(self, event: Event) -> None:
+        """
+        Stamp event before putting into queue.
+        """
+        if not self.active:
+            self.engine_put(event)
+            return
+
+        event.trace_ns = perf_counter_ns()
+
+        # Both general and vt_symbol tick events pushed by on_tick share its stamp
+        context: local = self.gateway_context
+        if event.data is not None and event.data is getattr(context, "tick", None):
+            event.receive_ns = context.receive_ns
+
+        self.engine_put(event)
+
+    def process(self, event: Event) -> None:
+        """
+        Time dispatching of event by the saved dispatch function, and keep
+        event in context for linking orders sent by handlers.
+        """
+        if not self.active:
+            self.engine_process(event)
+            return
+
+        context: local = self.context
+        context.event = event
+        context.start = perf_counter_ns()
+
+        try:
+            self.engine_process(event)
+        finally:
+            context.event = None
+            self.event_histograms[event.type].add(perf_counter_ns() - context.start)
+
+    def send_order(self, req: OrderRequest, gateway_name: str) -> str:
+        """
+        Time order sending and link it to the tick being dispatched.
+        """
+        start: int = perf_counter_ns()
+        vt_orderid: str = self.main_send_order(req, gateway_name)
+        end: int = perf_counter_ns()
+
+        if not self.active:
+            return vt_orderid
+
+        histograms: dict = self.histograms
+        reference: str = req.reference
+
+        histograms[("send", reference, gateway_name)].add(end - start)
+
+        event: Optional[Event] = getattr(self.context, "event", None)
+        if not event or not event.type.startswith(EVENT_TICK):
+            return vt_orderid
+
+        put_ns: int = getattr(event, "trace_ns", 0)
+        receive_ns: int = getattr(event, "receive_ns", 0) or put_ns
+        dispatch_ns: int = self.context.start
+
+        if put_ns:
+            histograms[("queue", reference, gateway_name)].add(dispatch_ns - put_ns)
+        if receive_ns:
+            histograms[("total", reference, gateway_name)].add(end - receive_ns)
+        histograms[("handler", reference, gateway_name)].add(start - dispatch_ns)
+
+        if vt_orderid:
+            tick: TickData = event.data
+            self.add_link(vt_orderid, tick.vt_symbol, put_ns)
+
+        return vt_orderid
+
+    def add_link(self, vt_orderid: str, vt_symbol: str, put_ns: int) -> None:
+        """
+        Record tick which caused the order.
+        """
+        self.links[vt_orderid] = (vt_symbol, put_ns)
+        self.link_queue.append(vt_orderid)
+
+        if len(self.link_queue) > self.link_limit:
+            self.links.pop(self.link_queue.popleft(), None)
+
+    def get_link(self, vt_orderid: str) -> Optional[Tuple[str, int]]:
+        """
+        Get vt_symbol and put time of tick which caused the order.
+        """
+        return self.links.get(vt_orderid, None)
+
+    def get_report(self) -> dict:
+        """
+        Get latency summary of all stages and dispatching of event types.
+        """
+        stages: dict = {}
+        for (stage, reference, gateway_name), histogram in list(self.histograms.items()):
+            key: str = f"{stage}|{reference}|{gateway_name}"
+            stages[key] = histogram.get_summary()
+
+        events: dict = {
+            type: histogram.get_summary()
+            for type, histogram in list(self.event_histograms.items())
+        }
+
+        return {"stages": stages, "events": events}
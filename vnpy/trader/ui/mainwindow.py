@@ -90,8 +90,8 @@ class MainWindow(QtWidgets.QMainWindow):
 
         self.save_window_setting("default")
 
-        tick_widget.itemDoubleClicked.connect(self.trading_widget.update_with_cell)
-        position_widget.itemDoubleClicked.connect(self.trading_widget.update_with_cell)
+        tick_widget.data_double_clicked.connect(self.trading_widget.update_with_data)
+        position_widget.data_double_clicked.connect(self.trading_widget.update_with_data)
 
     def init_menu(self) -> None:
         """"""
@@ -125,10 +125,7 @@ class MainWindow(QtWidgets.QMainWindow):
 
         all_apps: List[BaseApp] = self.main_engine.get_all_apps()
         for app in all_apps:
-            ui_module: ModuleType = import_module(app.app_module + ".ui")
-            widget_class: QtWidgets.QWidget = getattr(ui_module, app.widget_name)
-
-            func: Callable = partial(self.open_widget, widget_class, app.app_name)
+            func: Callable = partial(self.open_app_widget, app)
 
             self.add_action(app_menu, app.display_name, app.icon_name, func, True)
 
@@ -282,6 +279,15 @@ class MainWindow(QtWidgets.QMainWindow):
         else:
             widget.show()
 
+    def open_app_widget(self, app: BaseApp) -> None:
+        """
+        Import app ui module only when app widget opened first time.
+        """
+        ui_module: ModuleType = import_module(app.app_module + ".ui")
+        widget_class: QtWidgets.QWidget = getattr(ui_module, app.widget_name)
+
+        self.open_widget(widget_class, app.app_name)
+
     def save_window_setting(self, name: str) -> None:
         """
         Save current window size and state by trader path and setting name.
@@ -6,7 +6,9 @@ import csv
 from datetime import datetime
 import platform
 from enum import Enum
-from typing import Any, Dict, List
+from collections import defaultdict
+from threading import Lock
+from typing import Any, Callable, Dict, Iterable, List, Optional, Set, Type
 from copy import copy
 from tzlocal import get_localzone_name
 
@@ -18,11 +20,14 @@ from ..engine import MainEngine, Event, EventEngine
 from ..event import (
     EVENT_QUOTE,
     EVENT_TICK,
+    EVENT_CONTRACT,
     EVENT_TRADE,
     EVENT_ORDER,
     EVENT_POSITION,
     EVENT_ACCOUNT,
-    EVENT_LOG
+    EVENT_LOG,
+    EVENT_CONTRACTS,
+    EVENT_POSITIONS
 )
 from ..object import (
     OrderRequest,
@@ -49,19 +54,29 @@ COLOR_BLACK = QtGui.QColor("black")
 class BaseCell(QtWidgets.QTableWidgetItem):
     """
     General cell used in tablewidgets.
+
+    Text and color formatting are provided as class methods, so that
+    they can also be used by table models without creating any item.
     """
 
+    alignment: QtCore.Qt.AlignmentFlag = QtCore.Qt.AlignCenter
+
     def __init__(self, content: Any, data: Any) -> None:
         """"""
         super().__init__()
-        self.setTextAlignment(QtCore.Qt.AlignCenter)
+        self.setTextAlignment(self.alignment)
         self.set_content(content, data)
 
     def set_content(self, content: Any, data: Any) -> None:
         """
         Set text content.
         """
-        self.setText(str(content))
+        self.setText(self.get_text(content))
+
+        color: Optional[QtGui.QColor] = self.get_color(content)
+        if color:
+            self.setForeground(color)
+
         self._data = data
 
     def get_data(self) -> Any:
@@ -70,6 +85,20 @@ class BaseCell(QtWidgets.QTableWidgetItem):
         """
         return self._data
 
+    @classmethod
+    def get_text(cls, content: Any) -> str:
+        """
+        Get text to be shown for content.
+        """
+        return str(content)
+
+    @classmethod
+    def get_color(cls, content: Any) -> Optional[QtGui.QColor]:
+        """
+        Get foreground color for content, None for default color.
+        """
+        return None
+
 
 class EnumCell(BaseCell):
     """
@@ -80,12 +109,14 @@ class EnumCell(BaseCell):
         """"""
         super().__init__(content, data)
 
-    def set_content(self, content: Any, data: Any) -> None:
+    @classmethod
+    def get_text(cls, content: Any) -> str:
         """
-        Set text using enum.constant.value.
+        Get text using enum.constant.value.
         """
         if content:
-            super().set_content(content.value, data)
+            return str(content.value)
+        return ""
 
 
 class DirectionCell(EnumCell):
@@ -97,16 +128,15 @@ class DirectionCell(EnumCell):
         """"""
         super().__init__(content, data)
 
-    def set_content(self, content: Any, data: Any) -> None:
+    @classmethod
+    def get_color(cls, content: Any) -> Optional[QtGui.QColor]:
         """
         Cell color is set according to direction.
         """
-        super().set_content(content, data)
-
         if content is Direction.SHORT:
-            self.setForeground(COLOR_SHORT)
+            return COLOR_SHORT
         else:
-            self.setForeground(COLOR_LONG)
+            return COLOR_LONG
 
 
 class BidCell(BaseCell):
@@ -118,7 +148,10 @@ class BidCell(BaseCell):
         """"""
         super().__init__(content, data)
 
-        self.setForeground(COLOR_BID)
+    @classmethod
+    def get_color(cls, content: Any) -> Optional[QtGui.QColor]:
+        """"""
+        return COLOR_BID
 
 
 class AskCell(BaseCell):
@@ -130,7 +163,10 @@ class AskCell(BaseCell):
         """"""
         super().__init__(content, data)
 
-        self.setForeground(COLOR_ASK)
+    @classmethod
+    def get_color(cls, content: Any) -> Optional[QtGui.QColor]:
+        """"""
+        return COLOR_ASK
 
 
 class PnlCell(BaseCell):
@@ -142,17 +178,16 @@ class PnlCell(BaseCell):
         """"""
         super().__init__(content, data)
 
-    def set_content(self, content: Any, data: Any) -> None:
+    @classmethod
+    def get_color(cls, content: Any) -> Optional[QtGui.QColor]:
         """
         Cell color is set based on whether pnl is
         positive or negative.
         """
-        super().set_content(content, data)
-
         if str(content).startswith("-"):
-            self.setForeground(COLOR_SHORT)
+            return COLOR_SHORT
         else:
-            self.setForeground(COLOR_LONG)
+            return COLOR_LONG
 
 
 class TimeCell(BaseCell):
@@ -166,12 +201,13 @@ class TimeCell(BaseCell):
         """"""
         super().__init__(content, data)
 
-    def set_content(self, content: Any, data: Any) -> None:
+    @classmethod
+    def get_text(cls, content: Any) -> str:
         """"""
         if content is None:
-            return
+            return ""
 
-        content: datetime = content.astimezone(self.local_tz)
+        content: datetime = content.astimezone(cls.local_tz)
         timestamp: str = content.strftime("%H:%M:%S")
 
         millisecond: int = int(content.microsecond / 1000)
@@ -180,8 +216,7 @@ class TimeCell(BaseCell):
         else:
             timestamp = f"{timestamp}.000"
 
-        self.setText(timestamp)
-        self._data = data
+        return timestamp
 
 
 class DateCell(BaseCell):
@@ -193,13 +228,13 @@ class DateCell(BaseCell):
         """"""
         super().__init__(content, data)
 
-    def set_content(self, content: Any, data: Any) -> None:
+    @classmethod
+    def get_text(cls, content: Any) -> str:
         """"""
         if content is None:
-            return
+            return ""
 
-        self.setText(content.strftime("%Y-%m-%d"))
-        self._data = data
+        return content.strftime("%Y-%m-%d")
 
 
 class MsgCell(BaseCell):
@@ -207,23 +242,259 @@ class MsgCell(BaseCell):
     Cell used for showing msg data.
     """
 
+    alignment: QtCore.Qt.AlignmentFlag = QtCore.Qt.AlignLeft | QtCore.Qt.AlignVCenter
+
     def __init__(self, content: str, data: Any) -> None:
         """"""
         super().__init__(content, data)
-        self.setTextAlignment(QtCore.Qt.AlignLeft | QtCore.Qt.AlignVCenter)
 
 
-class BaseMonitor(QtWidgets.QTableWidget):
+class MonitorModel(QtCore.QAbstractTableModel):
+    """
+    Table model of monitor data.
+
+    Cell text and color are stored column by column in a ring buffer.
+    New data is appended in O(1) and shown at the top. Without data key
+    (trade, log) the oldest row is dropped once the row limit is reached,
+    while keyed data (orders, positions) is never dropped and the buffer
+    grows instead.
+    """
+
+    def __init__(
+        self,
+        headers: dict,
+        data_key: str,
+        row_limit: int,
+        parent: QtCore.QObject = None
+    ) -> None:
+        """"""
+        super().__init__(parent)
+
+        self.data_key: str = data_key
+        self.row_limit: int = row_limit
+
+        self.names: List[str] = list(headers.keys())
+        self.labels: List[str] = [d["display"] for d in headers.values()]
+        self.cell_types: List[Type[BaseCell]] = [d["cell"] for d in headers.values()]
+        self.alignments: list = [cell_type.alignment for cell_type in self.cell_types]
+        self.update_columns: List[int] = [
+            column for column, d in enumerate(headers.values()) if d["update"]
+        ]
+
+        # Ring buffer storage, with head pointing to the next slot to write
+        self.capacity: int = row_limit
+        self.datas: List[Any] = [None] * row_limit
+        self.texts: List[List[str]] = [[""] * row_limit for _n in self.names]
+        self.colors: List[List[Optional[QtGui.QColor]]] = [
+            [None] * row_limit for _n in self.names
+        ]
+        self.head: int = 0
+        self.count: int = 0
+
+        self.key_slots: Dict[str, int] = {}
+
+    def rowCount(self, parent: QtCore.QModelIndex = QtCore.QModelIndex()) -> int:
+        """"""
+        if parent.isValid():
+            return 0
+        return self.count
+
+    def columnCount(self, parent: QtCore.QModelIndex = QtCore.QModelIndex()) -> int:
+        """"""
+        if parent.isValid():
+            return 0
+        return len(self.names)
+
+    def headerData(
+        self,
+        section: int,
+        orientation: QtCore.Qt.Orientation,
+        role: int = QtCore.Qt.DisplayRole
+    ) -> Any:
+        """"""
+        if orientation == QtCore.Qt.Horizontal and role == QtCore.Qt.DisplayRole:
+            return self.labels[section]
+        return None
+
+    def data(self, index: QtCore.QModelIndex, role: int = QtCore.Qt.DisplayRole) -> Any:
+        """
+        Return cell content from buffer, only called for visible cells.
+        """
+        slot: int = (self.head - 1 - index.row()) % self.capacity
+
+        if role == QtCore.Qt.DisplayRole:
+            return self.texts[index.column()][slot]
+        elif role == QtCore.Qt.ForegroundRole:
+            return self.colors[index.column()][slot]
+        elif role == QtCore.Qt.TextAlignmentRole:
+            return self.alignments[index.column()]
+        return None
+
+    def get_data(self, row: int) -> Any:
+        """
+        Get data object of row.
+        """
+        if row < 0 or row >= self.count:
+            return None
+
+        slot: int = (self.head - 1 - row) % self.capacity
+        return self.datas[slot]
+
+    def get_row(self, slot: int) -> int:
+        """
+        Convert buffer slot to table row.
+        """
+        return (self.head - 1 - slot) % self.capacity
+
+    def update_datas(self, datas: List[Any]) -> None:
+        """
+        Update a batch of data into model.
+
+        Data with existing key is updated in place, others are inserted
+        at the top of table with one row insert notification.
+        """
+        new_datas: Dict[Any, Any] = {}
+        updated_rows: List[int] = []
+
+        for data in datas:
+            if self.data_key:
+                key: str = data.__getattribute__(self.data_key)
+
+                slot: Optional[int] = self.key_slots.get(key, None)
+                if slot is not None:
+                    self.datas[slot] = data
+                    for column in self.update_columns:
+                        self.write_cell(slot, column, data)
+                    updated_rows.append(self.get_row(slot))
+                    continue
+            else:
+                key: int = len(new_datas)
+
+            new_datas[key] = data
+
+        if updated_rows:
+            self.dataChanged.emit(
+                self.index(min(updated_rows), 0),
+                self.index(max(updated_rows), len(self.names) - 1)
+            )
+
+        if new_datas:
+            self.insert_datas(list(new_datas.values()))
+
+    def insert_datas(self, datas: List[Any]) -> None:
+        """
+        Insert new data at the top, dropping oldest rows of data without
+        key if necessary.
+        """
+        if self.data_key:
+            if self.count + len(datas) > self.capacity:
+                self.expand(max(self.capacity * 2, self.count + len(datas)))
+        else:
+            datas = datas[-self.row_limit:]
+
+        n: int = len(datas)
+
+        overflow: int = self.count + n - self.capacity
+        if overflow > 0:
+            self.beginRemoveRows(QtCore.QModelIndex(), self.count - overflow, self.count - 1)
+
+            for i in range(overflow):
+                slot: int = (self.head - self.count + i) % self.capacity
+                self.datas[slot] = None
+
+            self.count -= overflow
+            self.endRemoveRows()
+
+        self.beginInsertRows(QtCore.QModelIndex(), 0, n - 1)
+
+        for data in datas:
+            slot: int = self.head
+            self.datas[slot] = data
+
+            for column in range(len(self.names)):
+                self.write_cell(slot, column, data)
+
+            if self.data_key:
+                key: str = data.__getattribute__(self.data_key)
+                self.key_slots[key] = slot
+
+            self.head = (self.head + 1) % self.capacity
+
+        self.count += n
+        self.endInsertRows()
+
+    def expand(self, capacity: int) -> None:
+        """
+        Grow ring buffer, existing rows are moved to the beginning
+        without changing their row numbers.
+        """
+        slots: List[int] = [
+            (self.head - self.count + i) % self.capacity for i in range(self.count)
+        ]
+        padding: int = capacity - self.count
+
+        self.datas = [self.datas[slot] for slot in slots] + [None] * padding
+        self.texts = [[texts[slot] for slot in slots] + [""] * padding for texts in self.texts]
+        self.colors = [[colors[slot] for slot in slots] + [None] * padding for colors in self.colors]
+
+        self.capacity = capacity
+        self.head = self.count % capacity
+
+        if self.data_key:
+            self.key_slots = {
+                data.__getattribute__(self.data_key): slot
+                for slot, data in enumerate(self.datas[:self.count])
+            }
+
+    def write_cell(self, slot: int, column: int, data: Any) -> None:
+        """
+        Format data field into text and color of cell.
+        """
+        content: Any = data.__getattribute__(self.names[column])
+        cell_type: Type[BaseCell] = self.cell_types[column]
+
+        self.texts[column][slot] = cell_type.get_text(content)
+        self.colors[column][slot] = cell_type.get_color(content)
+
+
+class MonitorProxyModel(QtCore.QSortFilterProxyModel):
+    """
+    Proxy model for sorting and filtering monitor rows.
+    """
+
+    def __init__(self, filter_func: Callable, parent: QtCore.QObject = None) -> None:
+        """"""
+        super().__init__(parent)
+
+        self.filter_func: Callable = filter_func
+
+    def filterAcceptsRow(self, source_row: int, source_parent: QtCore.QModelIndex) -> bool:
+        """"""
+        data: Any = self.sourceModel().get_data(source_row)
+        return self.filter_func(data)
+
+
+class BaseMonitor(QtWidgets.QTableView):
     """
     Monitor data update.
+
+    Data pushed from event engine is buffered first, and then updated
+    into table model in batch by timer to keep UI responsive.
+
+    Table rows are views of data in MonitorModel, subclasses should get
+    data object of a row by get_data instead of accessing table items.
     """
 
     event_type: str = ""
+    batch_event_type: str = ""          # Event type with a list of data
     data_key: str = ""
     sorting: bool = False
     headers: dict = {}
+    refresh_interval: int = 100         # Milliseconds between two table refresh
+    row_limit: int = 10000              # Max rows kept without data key, oldest rows are dropped
 
     signal: QtCore.Signal = QtCore.Signal(Event)
+    data_double_clicked: QtCore.Signal = QtCore.Signal(object)
 
     def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
         """"""
@@ -231,7 +502,9 @@ class BaseMonitor(QtWidgets.QTableWidget):
 
         self.main_engine: MainEngine = main_engine
         self.event_engine: EventEngine = event_engine
-        self.cells: Dict[str, dict] = {}
+
+        self.buffer: Dict[Any, Any] = {}
+        self.buffer_lock: Lock = Lock()
 
         self.init_ui()
         self.load_setting()
@@ -242,17 +515,28 @@ class BaseMonitor(QtWidgets.QTableWidget):
         self.init_table()
         self.init_menu()
 
+        self.doubleClicked.connect(self.emit_double_clicked)
+
     def init_table(self) -> None:
         """
         Initialize table.
         """
-        self.setColumnCount(len(self.headers))
+        self.data_model: MonitorModel = MonitorModel(
+            self.headers, self.data_key, self.row_limit, self
+        )
 
-        labels: list = [d["display"] for d in self.headers.values()]
-        self.setHorizontalHeaderLabels(labels)
+        # Proxy model is only used when sorting is required
+        if self.sorting:
+            self.proxy_model: MonitorProxyModel = MonitorProxyModel(self.filter_data, self)
+            self.proxy_model.setSourceModel(self.data_model)
+            self.setModel(self.proxy_model)
+        else:
+            self.proxy_model = None
+            self.setModel(self.data_model)
 
         self.verticalHeader().setVisible(False)
         self.setEditTriggers(self.NoEditTriggers)
+        self.setSelectionBehavior(self.SelectRows)
         self.setAlternatingRowColors(True)
         self.setSortingEnabled(self.sorting)
 
@@ -274,66 +558,100 @@ class BaseMonitor(QtWidgets.QTableWidget):
         """
         Register event handler into event engine.
         """
+        # Kept for subclasses emitting events into table directly
+        self.signal.connect(self.process_event)
+
         if self.event_type:
-            self.signal.connect(self.process_event)
-            self.event_engine.register(self.event_type, self.signal.emit)
+            self.event_engine.register(self.event_type, self.buffer_event)
 
-    def process_event(self, event: Event) -> None:
+            if self.batch_event_type:
+                self.event_engine.register(self.batch_event_type, self.buffer_batch_event)
+
+            self.timer: QtCore.QTimer = QtCore.QTimer(self)
+            self.timer.setInterval(self.refresh_interval)
+            self.timer.timeout.connect(self.refresh_table)
+            self.timer.start()
+
+    def buffer_event(self, event: Event) -> None:
         """
-        Process new data from event and update into table.
+        Buffer new event pushed from event engine thread.
+
+        Events with the same data key are coalesced, so only
+        the latest one will be updated into table.
         """
-        # Disable sorting to prevent unwanted error.
-        if self.sorting:
-            self.setSortingEnabled(False)
+        with self.buffer_lock:
+            if self.data_key:
+                key: str = event.data.__getattribute__(self.data_key)
+            else:
+                key: int = len(self.buffer)
 
-        # Update data into table.
-        data = event.data
+            self.buffer[key] = event.data
 
-        if not self.data_key:
-            self.insert_new_row(data)
-        else:
-            key: str = data.__getattribute__(self.data_key)
+    def buffer_batch_event(self, event: Event) -> None:
+        """
+        Buffer list of data pushed in one batch event.
+        """
+        datas: list = event.data
 
-            if key in self.cells:
-                self.update_old_row(data)
+        with self.buffer_lock:
+            if self.data_key:
+                self.buffer.update({getattr(d, self.data_key): d for d in datas})
             else:
-                self.insert_new_row(data)
+                n: int = len(self.buffer)
+                self.buffer.update(zip(range(n, n + len(datas)), datas))
 
-        # Enable sorting
-        if self.sorting:
-            self.setSortingEnabled(True)
-
-    def insert_new_row(self, data: Any) -> None:
+    def refresh_table(self) -> None:
         """
-        Insert a new row at the top of table.
+        Update all buffered data into table model in one batch.
         """
-        self.insertRow(0)
+        with self.buffer_lock:
+            if not self.buffer:
+                return
 
-        row_cells: dict = {}
-        for column, header in enumerate(self.headers.keys()):
-            setting: dict = self.headers[header]
+            datas: list = list(self.buffer.values())
+            self.buffer = {}
 
-            content = data.__getattribute__(header)
-            cell: QtWidgets.QTableWidgetItem = setting["cell"](content, data)
-            self.setItem(0, column, cell)
+        self.data_model.update_datas(datas)
 
-            if setting["update"]:
-                row_cells[header] = cell
+    def process_event(self, event: Event) -> None:
+        """
+        Update data of event into table immediately.
+        """
+        self.data_model.update_datas([event.data])
 
-        if self.data_key:
-            key: str = data.__getattribute__(self.data_key)
-            self.cells[key] = row_cells
+    def insert_new_row(self, data: Any) -> None:
+        """
+        Insert a new row at the top of table.
+        """
+        self.data_model.insert_datas([data])
 
     def update_old_row(self, data: Any) -> None:
         """
-        Update an old row in table.
+        Update an existing row of data key.
         """
-        key: str = data.__getattribute__(self.data_key)
-        row_cells = self.cells[key]
+        self.data_model.update_datas([data])
 
-        for header, cell in row_cells.items():
-            content = data.__getattribute__(header)
-            cell.set_content(content, data)
+    def filter_data(self, data: Any) -> bool:
+        """
+        Check whether row of data should be shown (sorting monitor only).
+        """
+        return True
+
+    def get_data(self, index: QtCore.QModelIndex) -> Any:
+        """
+        Get data object of the row at view index.
+        """
+        if self.proxy_model:
+            index = self.proxy_model.mapToSource(index)
+        return self.data_model.get_data(index.row())
+
+    def emit_double_clicked(self, index: QtCore.QModelIndex) -> None:
+        """
+        Emit data object of the row double clicked.
+        """
+        data: Any = self.get_data(index)
+        if data:
+            self.data_double_clicked.emit(data)
 
     def resize_columns(self) -> None:
         """
@@ -357,17 +675,12 @@ class BaseMonitor(QtWidgets.QTableWidget):
             headers: list = [d["display"] for d in self.headers.values()]
             writer.writerow(headers)
 
-            for row in range(self.rowCount()):
-                if self.isRowHidden(row):
-                    continue
-
+            model: QtCore.QAbstractItemModel = self.model()
+            for row in range(model.rowCount()):
                 row_data: list = []
-                for column in range(self.columnCount()):
-                    item: QtWidgets.QTableWidgetItem = self.item(row, column)
-                    if item:
-                        row_data.append(str(item.text()))
-                    else:
-                        row_data.append("")
+                for column in range(model.columnCount()):
+                    text: str = model.index(row, column).data()
+                    row_data.append(text)
                 writer.writerow(row_data)
 
     def contextMenuEvent(self, event: QtGui.QContextMenuEvent) -> None:
@@ -489,13 +802,12 @@ class OrderMonitor(BaseMonitor):
         super().init_ui()
 
         self.setToolTip(_("双击单元格撤单"))
-        self.itemDoubleClicked.connect(self.cancel_order)
+        self.data_double_clicked.connect(self.cancel_order)
 
-    def cancel_order(self, cell: BaseCell) -> None:
+    def cancel_order(self, order: OrderData) -> None:
         """
         Cancel order if cell double clicked.
         """
-        order: OrderData = cell.get_data()
         req: CancelRequest = order.create_cancel_request()
         self.main_engine.cancel_order(req, order.gateway_name)
 
@@ -506,6 +818,7 @@ class PositionMonitor(BaseMonitor):
     """
 
     event_type: str = EVENT_POSITION
+    batch_event_type: str = EVENT_POSITIONS
     data_key: str = "vt_positionid"
     sorting: bool = True
 
@@ -572,13 +885,12 @@ class QuoteMonitor(BaseMonitor):
         super().init_ui()
 
         self.setToolTip(_("双击单元格撤销报价"))
-        self.itemDoubleClicked.connect(self.cancel_quote)
+        self.data_double_clicked.connect(self.cancel_quote)
 
-    def cancel_quote(self, cell: BaseCell) -> None:
+    def cancel_quote(self, quote: QuoteData) -> None:
         """
         Cancel quote if cell double clicked.
         """
-        quote: QuoteData = cell.get_data()
         req: CancelRequest = quote.create_cancel_request()
         self.main_engine.cancel_quote(req, quote.gateway_name)
 
@@ -675,7 +987,7 @@ class TradingWidget(QtWidgets.QWidget):
     General manual trading widget.
     """
 
-    signal_tick: QtCore.Signal = QtCore.Signal(Event)
+    refresh_interval: int = 100         # Milliseconds between two depth refresh
 
     def __init__(self, main_engine: MainEngine, event_engine: EventEngine) -> None:
         """"""
@@ -687,6 +999,10 @@ class TradingWidget(QtWidgets.QWidget):
         self.vt_symbol: str = ""
         self.price_digits: int = 0
 
+        self.tick: Optional[TickData] = None
+        self.shown_tick: Optional[TickData] = None
+        self.label_values: Dict[str, float] = {}
+
         self.init_ui()
         self.register_event()
 
@@ -814,6 +1130,24 @@ class TradingWidget(QtWidgets.QWidget):
         form.addRow(self.bp4_label, self.bv4_label)
         form.addRow(self.bp5_label, self.bv5_label)
 
+        # Label with tick field name and whether it shows price,
+        # the first 5 are always updated and the others only if
+        # tick has 5 levels of depth.
+        self.label_fields: list = [
+            (self.lp_label, "last_price", True),
+            (self.bp1_label, "bid_price_1", True),
+            (self.bv1_label, "bid_volume_1", False),
+            (self.ap1_label, "ask_price_1", True),
+            (self.av1_label, "ask_volume_1", False),
+        ]
+        for i in range(2, 6):
+            self.label_fields.extend([
+                (getattr(self, f"bp{i}_label"), f"bid_price_{i}", True),
+                (getattr(self, f"bv{i}_label"), f"bid_volume_{i}", False),
+                (getattr(self, f"ap{i}_label"), f"ask_price_{i}", True),
+                (getattr(self, f"av{i}_label"), f"ask_volume_{i}", False),
+            ])
+
         # Overall layout
         vbox: QtWidgets.QVBoxLayout = QtWidgets.QVBoxLayout()
         vbox.addLayout(grid)
@@ -835,51 +1169,61 @@ class TradingWidget(QtWidgets.QWidget):
         return label
 
     def register_event(self) -> None:
-        """"""
-        self.signal_tick.connect(self.process_tick_event)
-        self.event_engine.register(EVENT_TICK, self.signal_tick.emit)
+        """
+        Start timer to refresh depth display, tick event of
+        current symbol is registered in set_vt_symbol.
+        """
+        self.timer: QtCore.QTimer = QtCore.QTimer(self)
+        self.timer.setInterval(self.refresh_interval)
+        self.timer.timeout.connect(self.refresh_tick)
+        self.timer.start()
 
     def process_tick_event(self, event: Event) -> None:
-        """"""
-        tick: TickData = event.data
-        if tick.vt_symbol != self.vt_symbol:
+        """
+        Keep latest tick only, which is shown by timer later.
+        """
+        self.tick = event.data
+
+    def refresh_tick(self) -> None:
+        """
+        Update labels with latest tick if any new one received.
+        """
+        tick: Optional[TickData] = self.tick
+        if not tick or tick is self.shown_tick or tick.vt_symbol != self.vt_symbol:
             return
+        self.shown_tick = tick
 
-        price_digits: int = self.price_digits
+        if tick.bid_price_2:
+            fields: list = self.label_fields
+        else:
+            fields: list = self.label_fields[:5]
+
+        for label, name, is_price in fields:
+            value: float = getattr(tick, name)
 
-        self.lp_label.setText(f"{tick.last_price:.{price_digits}f}")
-        self.bp1_label.setText(f"{tick.bid_price_1:.{price_digits}f}")
-        self.bv1_label.setText(str(tick.bid_volume_1))
-        self.ap1_label.setText(f"{tick.ask_price_1:.{price_digits}f}")
-        self.av1_label.setText(str(tick.ask_volume_1))
+            # Only update label if value changed
+            if self.label_values.get(name, None) == value:
+                continue
+            self.label_values[name] = value
+
+            if is_price:
+                label.setText(f"{value:.{self.price_digits}f}")
+            else:
+                label.setText(str(value))
 
         if tick.pre_close:
             r: float = (tick.last_price / tick.pre_close - 1) * 100
-            self.return_label.setText(f"{r:.2f}%")
-
-        if tick.bid_price_2:
-            self.bp2_label.setText(f"{tick.bid_price_2:.{price_digits}f}")
-            self.bv2_label.setText(str(tick.bid_volume_2))
-            self.ap2_label.setText(f"{tick.ask_price_2:.{price_digits}f}")
-            self.av2_label.setText(str(tick.ask_volume_2))
-
-            self.bp3_label.setText(f"{tick.bid_price_3:.{price_digits}f}")
-            self.bv3_label.setText(str(tick.bid_volume_3))
-            self.ap3_label.setText(f"{tick.ask_price_3:.{price_digits}f}")
-            self.av3_label.setText(str(tick.ask_volume_3))
-
-            self.bp4_label.setText(f"{tick.bid_price_4:.{price_digits}f}")
-            self.bv4_label.setText(str(tick.bid_volume_4))
-            self.ap4_label.setText(f"{tick.ask_price_4:.{price_digits}f}")
-            self.av4_label.setText(str(tick.ask_volume_4))
-
-            self.bp5_label.setText(f"{tick.bid_price_5:.{price_digits}f}")
-            self.bv5_label.setText(str(tick.bid_volume_5))
-            self.ap5_label.setText(f"{tick.ask_price_5:.{price_digits}f}")
-            self.av5_label.setText(str(tick.ask_volume_5))
+            self.set_label_text(self.return_label, f"{r:.2f}%")
 
         if self.price_check.isChecked():
-            self.price_line.setText(f"{tick.last_price:.{price_digits}f}")
+            self.price_line.setText(f"{tick.last_price:.{self.price_digits}f}")
+
+    def set_label_text(self, label: QtWidgets.QLabel, text: str) -> None:
+        """
+        Set label text if changed.
+        """
+        if label.text() != text:
+            label.setText(text)
 
     def set_vt_symbol(self) -> None:
         """
@@ -895,7 +1239,15 @@ class TradingWidget(QtWidgets.QWidget):
 
         if vt_symbol == self.vt_symbol:
             return
+
+        # Switch tick event registration to new symbol
+        if self.vt_symbol:
+            self.event_engine.unregister(EVENT_TICK + self.vt_symbol, self.process_tick_event)
+        self.event_engine.register(EVENT_TICK + vt_symbol, self.process_tick_event)
+
         self.vt_symbol = vt_symbol
+        self.tick = None
+        self.shown_tick = None
 
         # Update name line widget and clear all labels
         contract: ContractData = self.main_engine.get_contract(vt_symbol)
@@ -928,6 +1280,8 @@ class TradingWidget(QtWidgets.QWidget):
         """
         Clear text on all labels.
         """
+        self.label_values.clear()
+
         self.lp_label.setText("")
         self.return_label.setText("")
 
@@ -1000,10 +1354,10 @@ class TradingWidget(QtWidgets.QWidget):
             req: CancelRequest = order.create_cancel_request()
             self.main_engine.cancel_order(req, order.gateway_name)
 
-    def update_with_cell(self, cell: BaseCell) -> None:
-        """"""
-        data = cell.get_data()
-
+    def update_with_data(self, data: Any) -> None:
+        """
+        Update widget with data object double clicked in monitor.
+        """
         self.symbol_line.setText(data.symbol)
         self.exchange_combo.setCurrentIndex(
             self.exchange_combo.findText(data.exchange.value)
@@ -1036,20 +1390,165 @@ class ActiveOrderMonitor(OrderMonitor):
     Monitor which shows active order only.
     """
 
-    def process_event(self, event) -> None:
+    def filter_data(self, data: Any) -> bool:
         """
         Hides the row if order is not active.
         """
-        super().process_event(event)
+        order: OrderData = data
+        return order.is_active()
+
+
+class ContractIndex:
+    """
+    Trigram index of contracts for fast substring search on vt_symbol.
+    """
+
+    gram_size: int = 3
+
+    def __init__(self) -> None:
+        """"""
+        self.contracts: List[ContractData] = []
+        self.ids: Dict[str, int] = {}
+        self.grams: Dict[str, Set[int]] = defaultdict(set)
+
+        # Result of last search, reused if new text extends it
+        self.last_text: str = ""
+        self.last_ids: List[int] = []
+
+    def update_contract(self, contract: ContractData) -> None:
+        """
+        Add new contract into index or replace the old one.
+        """
+        vt_symbol: str = contract.vt_symbol
+
+        contract_id: Optional[int] = self.ids.get(vt_symbol, None)
+        if contract_id is not None:
+            self.contracts[contract_id] = contract
+            return
+
+        contract_id = len(self.contracts)
+        self.contracts.append(contract)
+        self.ids[vt_symbol] = contract_id
+
+        n: int = self.gram_size
+        for i in range(len(vt_symbol) - n + 1):
+            self.grams[vt_symbol[i:i + n]].add(contract_id)
 
-        order: OrderData = event.data
-        row_cells: dict = self.cells[order.vt_orderid]
-        row: int = self.row(row_cells["volume"])
+        self.last_text = ""
+        self.last_ids = []
 
-        if order.is_active():
-            self.showRow(row)
+    def update_contracts(self, contracts: List[ContractData]) -> None:
+        """
+        Add or replace a batch of contracts.
+        """
+        for contract in contracts:
+            self.update_contract(contract)
+
+    def search(self, text: str) -> List[ContractData]:
+        """
+        Search contracts whose vt_symbol contains text.
+        """
+        if not text:
+            ids: List[int] = list(range(len(self.contracts)))
+        elif self.last_text and self.last_text in text:
+            ids = self.filter_ids(self.last_ids, text)
+        elif len(text) < self.gram_size:
+            ids = self.filter_ids(range(len(self.contracts)), text)
         else:
-            self.hideRow(row)
+            ids = self.filter_ids(self.get_candidates(text), text)
+
+        self.last_text = text
+        self.last_ids = ids
+
+        return [self.contracts[contract_id] for contract_id in ids]
+
+    def get_candidates(self, text: str) -> List[int]:
+        """
+        Intersect contract id sets of all grams in text.
+        """
+        n: int = self.gram_size
+        grams: Set[str] = {text[i:i + n] for i in range(len(text) - n + 1)}
+
+        id_sets: List[Set[int]] = []
+        for gram in grams:
+            id_set: Optional[Set[int]] = self.grams.get(gram, None)
+            if not id_set:
+                return []
+            id_sets.append(id_set)
+
+        id_sets.sort(key=len)
+        candidates: Set[int] = id_sets[0].intersection(*id_sets[1:])
+        return sorted(candidates)
+
+    def filter_ids(self, ids: Iterable[int], text: str) -> List[int]:
+        """
+        Keep ids whose vt_symbol contains text.
+        """
+        contracts: List[ContractData] = self.contracts
+        return [i for i in ids if text in contracts[i].vt_symbol]
+
+
+class ContractModel(QtCore.QAbstractTableModel):
+    """
+    Table model of contract search result.
+    """
+
+    def __init__(self, headers: Dict[str, str], parent: QtCore.QObject = None) -> None:
+        """"""
+        super().__init__(parent)
+
+        self.names: List[str] = list(headers.keys())
+        self.labels: List[str] = [f"{display}\n{name}" for name, display in headers.items()]
+        self.contracts: List[ContractData] = []
+
+    def set_contracts(self, contracts: List[ContractData]) -> None:
+        """
+        Replace all contracts shown in table.
+        """
+        self.beginResetModel()
+        self.contracts = contracts
+        self.endResetModel()
+
+    def rowCount(self, parent: QtCore.QModelIndex = QtCore.QModelIndex()) -> int:
+        """"""
+        if parent.isValid():
+            return 0
+        return len(self.contracts)
+
+    def columnCount(self, parent: QtCore.QModelIndex = QtCore.QModelIndex()) -> int:
+        """"""
+        if parent.isValid():
+            return 0
+        return len(self.names)
+
+    def headerData(
+        self,
+        section: int,
+        orientation: QtCore.Qt.Orientation,
+        role: int = QtCore.Qt.DisplayRole
+    ) -> Any:
+        """"""
+        if orientation == QtCore.Qt.Horizontal and role == QtCore.Qt.DisplayRole:
+            return self.labels[section]
+        return None
+
+    def data(self, index: QtCore.QModelIndex, role: int = QtCore.Qt.DisplayRole) -> Any:
+        """"""
+        if role == QtCore.Qt.DisplayRole:
+            contract: ContractData = self.contracts[index.row()]
+            value: object = getattr(contract, self.names[index.column()])
+
+            if value in {None, 0, 0.0}:
+                return ""
+            elif isinstance(value, Enum):
+                return EnumCell.get_text(value)
+            elif isinstance(value, datetime):
+                return DateCell.get_text(value)
+            else:
+                return BaseCell.get_text(value)
+        elif role == QtCore.Qt.TextAlignmentRole:
+            return QtCore.Qt.AlignCenter
+        return None
 
 
 class ContractManager(QtWidgets.QWidget):
@@ -1057,6 +1556,9 @@ class ContractManager(QtWidgets.QWidget):
     Query contract data available to trade in system.
     """
 
+    signal_contract: QtCore.Signal = QtCore.Signal(Event)
+    signal_contracts: QtCore.Signal = QtCore.Signal(Event)
+
     headers: Dict[str, str] = {
         "vt_symbol": _("本地代码"),
         "symbol": _("代码"),
@@ -1079,7 +1581,10 @@ class ContractManager(QtWidgets.QWidget):
         self.main_engine: MainEngine = main_engine
         self.event_engine: EventEngine = event_engine
 
+        self.contract_index: ContractIndex = ContractIndex()
+
         self.init_ui()
+        self.register_event()
 
     def init_ui(self) -> None:
         """"""
@@ -1088,18 +1593,15 @@ class ContractManager(QtWidgets.QWidget):
 
         self.filter_line: QtWidgets.QLineEdit = QtWidgets.QLineEdit()
         self.filter_line.setPlaceholderText(_("输入合约代码或者交易所，留空则查询所有合约"))
+        self.filter_line.textChanged.connect(self.search_contracts)
 
         self.button_show: QtWidgets.QPushButton = QtWidgets.QPushButton(_("查询"))
         self.button_show.clicked.connect(self.show_contracts)
 
-        labels: list = []
-        for name, display in self.headers.items():
-            label: str = f"{display}\n{name}"
-            labels.append(label)
+        self.contract_model: ContractModel = ContractModel(self.headers, self)
 
-        self.contract_table: QtWidgets.QTableWidget = QtWidgets.QTableWidget()
-        self.contract_table.setColumnCount(len(self.headers))
-        self.contract_table.setHorizontalHeaderLabels(labels)
+        self.contract_table: QtWidgets.QTableView = QtWidgets.QTableView()
+        self.contract_table.setModel(self.contract_model)
         self.contract_table.verticalHeader().setVisible(False)
         self.contract_table.setEditTriggers(self.contract_table.NoEditTriggers)
         self.contract_table.setAlternatingRowColors(True)
@@ -1114,38 +1616,52 @@ class ContractManager(QtWidgets.QWidget):
 
         self.setLayout(vbox)
 
-    def show_contracts(self) -> None:
+    def register_event(self) -> None:
         """
-        Show contracts by symbol
+        Build index with existing contracts and keep it updated.
         """
-        flt: str = str(self.filter_line.text())
+        self.signal_contract.connect(self.process_contract_event)
+        self.event_engine.register(EVENT_CONTRACT, self.emit_contract_event)
 
-        all_contracts: List[ContractData] = self.main_engine.get_all_contracts()
-        if flt:
-            contracts: List[ContractData] = [
-                contract for contract in all_contracts if flt in contract.vt_symbol
-            ]
-        else:
-            contracts: List[ContractData] = all_contracts
+        self.signal_contracts.connect(self.process_contracts_event)
+        self.event_engine.register(EVENT_CONTRACTS, self.emit_contracts_event)
 
-        self.contract_table.clearContents()
-        self.contract_table.setRowCount(len(contracts))
+        self.contract_index.update_contracts(self.main_engine.get_all_contracts())
 
-        for row, contract in enumerate(contracts):
-            for column, name in enumerate(self.headers.keys()):
-                value: object = getattr(contract, name)
+    def emit_contract_event(self, event: Event) -> None:
+        """"""
+        self.signal_contract.emit(event)
 
-                if value in {None, 0, 0.0}:
-                    value = ""
+    def emit_contracts_event(self, event: Event) -> None:
+        """
+        Batch event is emitted as one signal, and records of batch are
+        not passed to emit_contract_event as both are bound to manager.
+        """
+        self.signal_contracts.emit(event)
 
-                if isinstance(value, Enum):
-                    cell: EnumCell = EnumCell(value, contract)
-                elif isinstance(value, datetime):
-                    cell: DateCell = DateCell(value, contract)
-                else:
-                    cell: BaseCell = BaseCell(value, contract)
-                self.contract_table.setItem(row, column, cell)
+    def process_contract_event(self, event: Event) -> None:
+        """"""
+        contract: ContractData = event.data
+        self.contract_index.update_contract(contract)
+
+    def process_contracts_event(self, event: Event) -> None:
+        """"""
+        self.contract_index.update_contracts(event.data)
+
+    def search_contracts(self) -> None:
+        """
+        Update search result with text in filter line.
+        """
+        flt: str = str(self.filter_line.text())
 
+        contracts: List[ContractData] = self.contract_index.search(flt)
+        self.contract_model.set_contracts(contracts)
+
+    def show_contracts(self) -> None:
+        """
+        Show contracts by symbol
+        """
+        self.search_contracts()
         self.contract_table.resizeColumnsToContents()
 
 
@@ -8,6 +8,7 @@ import sys
 from datetime import datetime, time
 from pathlib import Path
 from typing import Callable, Dict, Tuple, Union, Optional
+from functools import lru_cache
 from decimal import Decimal
 from math import floor, ceil
 
@@ -124,10 +125,91 @@ def save_json(filename: str, data: dict) -> None:
         )
 
 
+# Quotient of value and target must be below this for fast rounding
+MAX_QUOTIENT: float = 1e9
+
+# Error bound of float quotient compared with exact decimal quotient
+QUOTIENT_TOLERANCE: float = 1e-6
+
+# Max integer of which all digits are exactly kept by float
+MAX_EXACT_DIGITS: int = 10 ** 15
+
+
+@lru_cache(maxsize=1024)
+def get_tick_ratio(target: float) -> Optional[Tuple[int, int]]:
+    """
+    Get numerator and power of 10 denominator of target in decimal,
+    None if target is not positive.
+    """
+    target: Decimal = Decimal(str(target))
+    if not target.is_finite() or target <= 0:
+        return None
+
+    _, digits, exponent = target.as_tuple()
+
+    numerator: int = int("".join(map(str, digits)))
+    if exponent >= 0:
+        return numerator * 10 ** exponent, 1
+    else:
+        return numerator, 10 ** -exponent
+
+
+def is_tick_multiple(value: float, n: int, numerator: int, denominator: int) -> bool:
+    """
+    Check if decimal of value is exactly n * numerator / denominator.
+
+    Decimals with no more than 15 digits are mapped to different floats,
+    so equal float means equal decimal.
+    """
+    product: int = n * numerator
+    return -MAX_EXACT_DIGITS < product < MAX_EXACT_DIGITS and product / denominator == value
+
+
+def get_tick_count(value: float, target: float, ratio: Tuple[int, int], mode: int) -> Optional[int]:
+    """
+    Get number of ticks in value rounded by mode (0 round, -1 floor,
+    1 ceil), same as calculated with Decimal. None is returned if the
+    float quotient is too close to rounding boundary to decide.
+    """
+    quotient: float = value / target
+    if not -MAX_QUOTIENT < quotient < MAX_QUOTIENT:
+        return None
+
+    n: int = floor(quotient)
+    fraction: float = quotient - n
+
+    if not mode:
+        if fraction < 0.5 - QUOTIENT_TOLERANCE:
+            return n
+        elif fraction > 0.5 + QUOTIENT_TOLERANCE:
+            return n + 1
+
+        # Exactly half tick is rounded to even like Decimal
+        numerator, denominator = ratio
+        if is_tick_multiple(value, (2 * n + 1) * 5, numerator, denominator * 10):
+            return n + (n & 1)
+        return None
+
+    if QUOTIENT_TOLERANCE < fraction < 1 - QUOTIENT_TOLERANCE:
+        return n if mode < 0 else n + 1
+
+    # Value on tick is kept unchanged
+    n = round(quotient)
+    if is_tick_multiple(value, n, *ratio):
+        return n
+    return None
+
+
 def round_to(value: float, target: float) -> float:
     """
     Round price to price tick value.
     """
+    ratio: Optional[Tuple[int, int]] = get_tick_ratio(target)
+    if ratio:
+        n: Optional[int] = get_tick_count(value, target, ratio, 0)
+        if n is not None:
+            return n * ratio[0] / ratio[1]
+
     value: Decimal = Decimal(str(value))
     target: Decimal = Decimal(str(target))
     rounded: float = float(int(round(value / target)) * target)
@@ -138,6 +220,12 @@ def floor_to(value: float, target: float) -> float:
     """
     Similar to math.floor function, but to target float number.
     """
+    ratio: Optional[Tuple[int, int]] = get_tick_ratio(target)
+    if ratio:
+        n: Optional[int] = get_tick_count(value, target, ratio, -1)
+        if n is not None:
+            return n * ratio[0] / ratio[1]
+
     value: Decimal = Decimal(str(value))
     target: Decimal = Decimal(str(target))
     result: float = float(int(floor(value / target)) * target)
@@ -148,12 +236,83 @@ def ceil_to(value: float, target: float) -> float:
     """
     Similar to math.ceil function, but to target float number.
     """
+    ratio: Optional[Tuple[int, int]] = get_tick_ratio(target)
+    if ratio:
+        n: Optional[int] = get_tick_count(value, target, ratio, 1)
+        if n is not None:
+            return n * ratio[0] / ratio[1]
+
     value: Decimal = Decimal(str(value))
     target: Decimal = Decimal(str(target))
     result: float = float(int(ceil(value / target)) * target)
     return result
 
 
+def round_array_to(values: np.ndarray, target: float, mode: int = 0) -> np.ndarray:
+    """
+    Round array of prices to price tick value by mode (0 round,
+    -1 floor, 1 ceil), with results same as scalar functions.
+    """
+    func: Callable = {0: round_to, -1: floor_to, 1: ceil_to}[mode]
+    values = np.asarray(values, dtype=float)
+
+    ratio: Optional[Tuple[int, int]] = get_tick_ratio(target)
+
+    # Tick count times numerator must be exact in float
+    if not ratio or ratio[0] * MAX_QUOTIENT >= 2 ** 53 or ratio[1] > 10 ** 22:
+        return np.array([func(v, target) for v in values.flat]).reshape(values.shape)
+
+    numerator, denominator = ratio
+
+    with np.errstate(invalid="ignore", divide="ignore"):
+        quotient: np.ndarray = values / target
+
+    valid: np.ndarray = np.abs(quotient) < MAX_QUOTIENT
+    quotient = np.where(valid, quotient, 0)
+
+    n: np.ndarray = np.floor(quotient)
+    fraction: np.ndarray = quotient - n
+
+    if not mode:
+        n += fraction > 0.5
+        decided: np.ndarray = np.abs(fraction - 0.5) > QUOTIENT_TOLERANCE
+    else:
+        if mode > 0:
+            n += 1
+        decided = (fraction > QUOTIENT_TOLERANCE) & (fraction < 1 - QUOTIENT_TOLERANCE)
+
+        # Value on tick is kept unchanged
+        on_tick: np.ndarray = np.round(quotient)
+        product: np.ndarray = on_tick * numerator
+        exact: np.ndarray = (np.abs(product) < MAX_EXACT_DIGITS) & (product / denominator == values)
+        n = np.where(exact, on_tick, n)
+        decided |= exact
+
+    # Float product and division are exact and correctly rounded as int
+    result: np.ndarray = (n + 0.0) * numerator / denominator
+
+    # Values undecided with float are calculated by scalar function
+    undecided: np.ndarray = ~(decided & valid)
+    if undecided.any():
+        result[undecided] = [func(v, target) for v in values[undecided]]
+
+    return result
+
+
+def floor_array_to(values: np.ndarray, target: float) -> np.ndarray:
+    """
+    Floor array of prices to price tick value.
+    """
+    return round_array_to(values, target, -1)
+
+
+def ceil_array_to(values: np.ndarray, target: float) -> np.ndarray:
+    """
+    Ceil array of prices to price tick value.
+    """
+    return round_array_to(values, target, 1)
+
+
 def get_digits(value: float) -> int:
     """
     Get number of digits after decimal point.